@@ -0,0 +1,80 @@
+#ifndef AUTOMATONANALYZER_H
+#define AUTOMATONANALYZER_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include "PDA.h"
+
+// Static analysis of a definition that points at the sources of search blowup before any input
+// is run: nondeterministic (state, stack top) pairs, epsilon cycles and their effect on the
+// stack, epsilon transitions that grow the stack, and states where input and epsilon
+// transitions compete. From these it estimates how the depth-first search of
+// PDA::processRecursive will behave on long inputs.
+//
+// The analysis only looks at the transitions, not at which stacks are reachable, so it
+// over-approximates: every finding is a possible problem, not a proven one.
+class AutomatonAnalyzer {
+  public:
+    enum Risk {
+      LINEAR,          // Deterministic: one path per input
+      BOUNDED,         // Choices exist but none on a cycle: a constant number of paths
+      EXPONENTIAL,     // A choice on a cycle: up to b^n paths for an input of length n
+      NON_TERMINATING  // An epsilon cycle that does not shrink the stack: the search may never end
+    };
+
+    // Stack bound applied to epsilon closures when the caller gives none and an epsilon cycle
+    // can grow the stack (see closureStackBound). It only keeps the closures finite: one can still
+    // hold every stack up to this height, so callers that can should ask for a bound instead.
+    static const size_t DEFAULT_STACK_BOUND = 1000;
+
+    AutomatonAnalyzer(const PDA& pda);
+
+    // Bound on the stack height for simulations that close sets of configurations under epsilon
+    // transitions: maxStackHeight if given, otherwise DEFAULT_STACK_BOUND when an epsilon cycle
+    // can grow the stack (the closure could be infinite) and 0 (unbounded) when none can
+    static size_t closureStackBound(const PDA& pda, size_t maxStackHeight);
+
+    void writeReport(std::ostream& out) const;
+
+    Risk getRisk() const;
+    size_t getMaxBranching() const;
+    bool hasGrowingEpsilonCycle() const;
+
+  private:
+    // Branching of a (state, stack top) pair. The top is '\0' for the empty stack.
+    struct Branching {
+      size_t state;
+      Symbol top;
+      size_t maxBranching;  // Over every input symbol
+      Symbol worstSymbol;   // Input symbol reaching it
+      size_t endOfInput;    // Candidates once the input is consumed (epsilon moves only)
+      std::string inputSymbols; // Text of the symbols read by a competing input transition
+      bool overlapsEpsilon; // Input and epsilon transitions are both candidates
+    };
+    struct EpsilonCycle {
+      std::vector<size_t> states;
+      std::vector<size_t> transitions;
+      int trend; // Over the worst cycle: 1 the stack grows, 0 it comes back unchanged, -1 it shrinks
+    };
+
+    static std::vector<std::vector<size_t> > stronglyConnectedComponents(
+      const std::vector<std::vector<size_t> >& successors);
+    static long long stackEffect(const Transition& transition);
+    std::string describe(size_t transition) const;
+
+    const PDA& pda;
+    std::vector<std::string> stateNames;
+    std::vector<size_t> sourceState; // Per transition
+    std::vector<size_t> targetState;
+    std::vector<Branching> branchings;
+    std::vector<EpsilonCycle> epsilonCycles;
+    std::vector<size_t> growingEpsilonTransitions;
+    std::vector<bool> inEpsilonCycle; // Per transition
+    std::vector<bool> onCycle; // Per state, through any transitions
+    Risk risk;
+    size_t maxBranching;
+    size_t maxBranchingOnCycle;
+};
+
+#endif // AUTOMATONANALYZER_H
@@ -0,0 +1,45 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <string>
+#include <vector>
+#include "PDA.h"
+#include "InputTrie.h"
+#include "SearchBudget.h"
+
+// Processes a whole batch of inputs at once over a trie of the inputs. The set of live
+// configurations is advanced once per trie edge and only forks where inputs diverge, so the
+// work is proportional to the size of the trie instead of the total length of the batch.
+class BatchProcessor {
+  public:
+    BatchProcessor(const PDA& pda);
+
+    // Returns one verdict per input, in the same order as the inputs
+    std::vector<Verdict> processBatch(const std::vector<SymbolString>& inputs);
+
+    // Bound on the stack height explored (0 = unbounded, or AutomatonAnalyzer's default bound
+    // if an epsilon cycle can grow the stack). Inputs whose rejection depends on a discarded
+    // configuration are reported as Unknown.
+    void setMaxStackHeight(size_t maxStackHeight);
+
+    // Statistics of the last batch
+    size_t getTrieNodeCount() const;
+    size_t getNodesVisited() const;
+
+  private:
+    struct PendingNode {
+      size_t node;
+      bool truncated;
+      std::set<Configuration> configurations;
+    };
+
+    static void markSubtree(const InputTrie& trie, size_t node, Verdict verdict,
+                            std::vector<Verdict>& verdictAtNode);
+
+    const PDA& pda;
+    size_t maxStackHeight;
+    size_t trieNodeCount;
+    size_t nodesVisited;
+};
+
+#endif // BATCHPROCESSOR_H
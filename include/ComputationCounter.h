@@ -0,0 +1,95 @@
+#ifndef COMPUTATIONCOUNTER_H
+#define COMPUTATIONCOUNTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "PDA.h"
+
+// Counts the distinct accepting computations (sequences of transitions from the initial
+// configuration that consume the whole input and end in an accepting configuration) with a
+// dynamic program over (state, input span, stack symbol, state) items, instead of enumerating
+// paths. Its cost is polynomial in the length of the input: O(n^3) items of the form
+// "from state p with X on top, consume w[i..j) and pop X ending in state q".
+//
+// Counts saturate: SATURATED means at least 2^64 - 2 computations, INFINITE means there are
+// infinitely many (an epsilon cycle lies on some accepting computation).
+class ComputationCounter {
+  public:
+    static const uint64_t INFINITE;
+    static const uint64_t SATURATED;
+
+    ComputationCounter(const PDA& pda);
+
+    uint64_t count(const SymbolString& input);
+    static std::string toString(uint64_t count);
+
+  private:
+    static const size_t NONE;
+
+    // Transition applicable with a symbol on top. Stack-epsilon transitions are expanded into
+    // one pop transition per stack symbol that pushes the symbol back.
+    struct PopTransition {
+      size_t from;
+      Symbol inputSymbol;
+      size_t popSymbol;
+      size_t to;
+      size_t firstSuffix; // NONE if nothing is pushed
+    };
+    // Stack-epsilon transition taken with an empty stack
+    struct EmptyTransition {
+      size_t from;
+      Symbol inputSymbol;
+      size_t to;
+      size_t firstSuffix;
+    };
+    // Suffix u[l..m] of a pushed string: the symbol u[l] and the suffix that follows it
+    struct Suffix {
+      size_t symbol;
+      size_t next;
+    };
+
+    enum ItemKind {
+      POP,          // T(p, X, q, i, j): from (p, X) consume w[i..j) and pop X, ending in q
+      POP_SUFFIX,   // B(c, s, q, i, j): from s, pop every symbol of suffix c over w[i..j), ending in q
+      ACCEPT,       // A(p, X, i): accepted from (p, X) at i without ever popping X
+      ACCEPT_SUFFIX,// Accepted from s with suffix c on top at i before popping all of it
+      EMPTY,        // R(q, i): accepted from q with an empty stack at i
+      EMPTY_SUFFIX  // Accepted from s at i with suffix c of an empty-stack push on the stack
+    };
+    struct Item {
+      ItemKind kind;
+      size_t a;
+      size_t b;
+      size_t c;
+      size_t i;
+      size_t j;
+    };
+
+    size_t indexOf(const Item& item) const;
+    template <typename Callback>
+    void forEachTerm(const Item& item, Callback callback) const;
+    void solveGroup(const std::vector<Item>& group);
+
+    static uint64_t add(uint64_t a, uint64_t b);
+    static uint64_t multiply(uint64_t a, uint64_t b);
+
+    size_t stateCount;
+    size_t symbolCount;
+    size_t initialState;
+    size_t initialSymbol;
+    bool useFinalStateAcceptance;
+    std::vector<bool> finalStates;
+    std::vector<PopTransition> popTransitions;
+    std::vector<EmptyTransition> emptyTransitions;
+    std::vector<Suffix> popSuffixes;
+    std::vector<Suffix> emptySuffixes;
+
+    // State of the current count
+    SymbolString input;
+    size_t span; // input length + 1
+    size_t offsets[6];
+    std::vector<uint64_t> values;
+};
+
+#endif // COMPUTATIONCOUNTER_H
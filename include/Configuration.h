@@ -0,0 +1,25 @@
+#ifndef CONFIGURATION_H
+#define CONFIGURATION_H
+
+#include "State.h"
+#include "Stack.h"
+
+// Instantaneous description of the PDA without the input: current state and stack contents.
+class Configuration {
+  public:
+    Configuration(const State& state, const Stack& stack);
+
+    // Getters
+    const State& getState() const;
+    const Stack& getStack() const;
+
+    // Overloaded operators for comparison (needed for use in sets)
+    bool operator<(const Configuration& other) const;
+    bool operator==(const Configuration& other) const;
+
+  private:
+    State state;
+    Stack stack;
+};
+
+#endif // CONFIGURATION_H
@@ -0,0 +1,68 @@
+#ifndef COUNTERPDA_H
+#define COUNTERPDA_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "PDA.h"
+
+// Specialized engine for automata whose stack is always a bottom marker followed by blocks of
+// at most MAX_COUNTERS symbols in a fixed order (e.g. S A^n for a^n b^n, or S A^n B^m). Such a
+// stack is fully described by one integer per symbol, so a configuration is a handful of
+// integers and copying it for a new branch is O(1).
+class CounterPDA {
+  public:
+    static const size_t MAX_COUNTERS = 4;
+
+    CounterPDA();
+
+    // Detects the counter pattern in the PDA and compiles it. Returns false (and leaves the
+    // engine unusable) if the automaton does not follow it. Transitions are tried in the PDA's
+    // dispatch order, so compile after PDA::reorderTransitions.
+    bool compile(const PDA& pda);
+
+    bool isCompiled() const;
+    size_t getCounterCount() const;
+
+    // Same verdict as PDA::processInput
+    bool processInput(const SymbolString& input) const;
+
+  private:
+    struct Configuration {
+      uint32_t state;
+      uint32_t hasBottom; // Whether the bottom marker is still on the stack
+      uint32_t counts[MAX_COUNTERS];
+    };
+
+    // Pending configuration of the search, which keeps its own stack of frames
+    struct Frame {
+      Configuration configuration;
+      size_t position; // Symbols of the input consumed
+      size_t nextTransition; // Index into the bucket of the state
+    };
+
+    struct CounterTransition {
+      uint32_t nextState;
+      Symbol inputSymbol;    // '\0' for epsilon
+      int popSymbol;         // Counter index, BOTTOM, or NO_POP for stack-epsilon transitions
+      uint32_t pushes[MAX_COUNTERS];
+      bool pushesBottom;
+    };
+
+    static const int BOTTOM = -1;
+    static const int NO_POP = -2;
+    static const int EMPTY = -3;
+
+    int top(const Configuration& configuration) const;
+    bool apply(const CounterTransition& transition, Configuration& configuration) const;
+    bool search(const SymbolString& input, const Configuration& initial) const;
+
+    bool compiled;
+    bool useFinalStateAcceptance;
+    size_t counterCount;
+    uint32_t initialState;
+    std::vector<bool> finalStates;
+    std::vector<std::vector<CounterTransition> > transitionsByState; // PDA dispatch order
+};
+
+#endif // COUNTERPDA_H
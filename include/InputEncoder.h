@@ -0,0 +1,58 @@
+#ifndef INPUTENCODER_H
+#define INPUTENCODER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "PDA.h"
+
+// Vectorized pre-pass over raw inputs. Finds invalid symbols through a lookup table built from
+// the input alphabet and computes the per-symbol counts (Parikh vector) used to screen out
+// inputs that cannot be accepted before searching.
+//
+// Alphabet symbols that no transition reads are treated as invalid as well: an input containing
+// one can never be fully consumed.
+class InputEncoder {
+  public:
+    InputEncoder(const PDA& pda);
+
+    // Fills counts with the Parikh vector, indexed by dense symbol index (0 .. alphabet size - 1).
+    // Returns false if the input contains an invalid symbol; firstInvalid is then its position.
+    bool scan(const SymbolString& input, std::vector<size_t>& counts, size_t& firstInvalid) const;
+
+    // Necessary conditions on the Parikh vector, e.g. "a=b", "a<=b", "c>0" or "a!=b".
+    // Each side is an input symbol (a byte or <NNN>) or a non-negative integer. Symbols win over
+    // integers: "0=1" on a {0, 1} alphabet compares two symbols, and counts are then written #N.
+    bool addConstraint(const std::string& constraint);
+
+    // True if the input only has valid symbols and satisfies every constraint.
+    // A false result means the PDA rejects the input.
+    bool mayAccept(const SymbolString& input) const;
+
+  private:
+    struct Operand {
+      bool isSymbol;
+      size_t value; // Dense symbol index or constant
+    };
+    struct Constraint {
+      Operand left;
+      std::string relation;
+      Operand right;
+    };
+
+    bool parseOperand(const std::string& text, Operand& operand) const;
+    bool parseSymbolOperand(const std::string& text, Operand& operand) const;
+    bool satisfies(const Constraint& constraint, const std::vector<size_t>& counts) const;
+    size_t code(Symbol symbol) const;
+
+    // Dense index + 1 for every valid symbol, 0 for invalid ones. Symbol values above 255 (only
+    // in 16 and 32-bit builds) go through the hash table.
+    uint32_t lookup[256];
+    std::unordered_map<Symbol, uint32_t> wideLookup;
+    std::vector<Symbol> alphabet; // Dense index -> symbol
+    SymbolString declaredSymbols; // Whole input alphabet, for parsing constraints
+    std::vector<Constraint> constraints;
+};
+
+#endif // INPUTENCODER_H
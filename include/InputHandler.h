@@ -8,7 +8,10 @@
 class InputHandler {
 public:
     static bool loadAutomatonDefinition(PDA& pda, const std::string& filename);
-    static std::vector<std::string> loadInputStrings(const std::string& filename);
+    static std::vector<SymbolString> loadInputStrings(const std::string& filename);
+    // Token streams: one input per line, each a whitespace-separated list of symbol values. The
+    // whole file is checked first: false, with no inputs, if it cannot be read or a token is invalid.
+    static bool loadTokenStrings(const std::string& filename, std::vector<SymbolString>& inputStrings);
     static void writeTraceOutput(const std::string& trace, const std::string& filename);
 };
 
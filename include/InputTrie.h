@@ -0,0 +1,32 @@
+#ifndef INPUTTRIE_H
+#define INPUTTRIE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include "Symbol.h"
+
+// Prefix tree of input strings. Identical prefixes share nodes, so a batch with common
+// headers is stored (and later simulated) only once per distinct prefix.
+class InputTrie {
+  public:
+    InputTrie();
+
+    // Inserts an input and returns the id of the node where it ends
+    size_t insert(const SymbolString& input);
+
+    size_t getNodeCount() const;
+    const std::map<Symbol, size_t>& getChildren(size_t node) const;
+    bool isTerminal(size_t node) const;
+
+    static const size_t ROOT = 0;
+
+  private:
+    struct Node {
+      std::map<Symbol, size_t> children;
+      bool terminal;
+    };
+    std::vector<Node> nodes;
+};
+
+#endif // INPUTTRIE_H
@@ -0,0 +1,77 @@
+#ifndef LANGUAGEGENERATOR_H
+#define LANGUAGEGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <ostream>
+#include <cstdint>
+#include "PDA.h"
+#include "Configuration.h"
+#include "ViabilityAutomaton.h"
+
+// Generates the accepted strings of length up to a bound without running the search on
+// candidates. The reachable epsilon-closed configuration sets are interned as the nodes of a
+// deterministic graph (one edge per input symbol), so every string corresponds to exactly one
+// path. A table N(S, n) with the number of strings of length n accepted from node S then drives
+// an output-sensitive enumeration (branches with no accepted completion are never entered) and
+// exact uniform sampling.
+//
+// Configurations whose shortest accepted continuation (ViabilityAutomaton::distance) is longer
+// than the length left are dropped as the graph is built, so nodes that only lead to strings
+// beyond the bound are never created.
+//
+// Counts saturate at SATURATED; sampling needs exact counts and is refused past that point.
+class LanguageGenerator {
+  public:
+    static const uint64_t SATURATED;
+
+    // maxStackHeight bounds the stack of the configurations explored (0 = unbounded, unless an
+    // epsilon cycle can grow the stack: then AutomatonAnalyzer's default bound applies)
+    LanguageGenerator(const PDA& pda, size_t maxLength, size_t maxStackHeight = 0);
+
+    // Accepted strings of length up to maxLength (saturating)
+    uint64_t countStrings() const;
+
+    // Writes the accepted strings in length-lexicographic order, one per line, at most limit of
+    // them (0 = all). Returns the number written.
+    size_t enumerate(std::ostream& out, size_t limit = 0) const;
+
+    // Writes count accepted strings drawn uniformly and independently. Returns false if the
+    // number of strings is too large to be counted exactly.
+    bool sample(std::ostream& out, size_t count, uint64_t seed) const;
+
+    // True if the stack height bound discarded configurations, so some strings may be missing
+    bool isTruncated() const;
+    size_t getNodeCount() const;
+
+  private:
+    static const size_t DEAD;
+    static const size_t BUFFER_LIMIT = 1 << 20;
+
+    struct Node {
+      size_t depth;                     // Length of the shortest string reaching the node
+      std::vector<size_t> next;         // Successor per input symbol, DEAD if no configuration survives
+      std::vector<uint64_t> exactCounts; // [n] = accepted strings of length n, n <= maxLength - depth
+    };
+
+    size_t intern(const std::set<Configuration>& configurations, size_t depth);
+    std::set<Configuration> successor(const std::set<Configuration>& configurations, Symbol symbol,
+                                      size_t remaining);
+    void prune(std::set<Configuration>& configurations, size_t remaining) const;
+    void enumerateFrom(size_t node, size_t remaining, SymbolString& prefix, std::string& buffer,
+                       std::ostream& out, size_t limit, size_t& written) const;
+
+    const PDA& pda;
+    size_t maxLength;
+    ViabilityAutomaton completion; // Weighted by input symbols read, up to maxLength
+    size_t maxStackHeight;
+    bool truncated;
+    std::vector<Symbol> symbols;
+    std::vector<Node> nodes;
+    std::map<std::set<Configuration>, size_t> nodeIds;
+    std::vector<const std::set<Configuration>*> nodeConfigurations;
+};
+
+#endif // LANGUAGEGENERATOR_H
@@ -5,20 +5,25 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <chrono>
 #include "State.h"
 #include "Transition.h"
 #include "Stack.h"
+#include "Configuration.h"
+#include "SearchBudget.h"
 
 class PDA {
 private:
     // Automaton components
     std::set<State> states;
-    std::set<char> inputAlphabet;
-    std::set<char> stackAlphabet;
+    std::set<Symbol> inputAlphabet;
+    std::set<Symbol> stackAlphabet;
     State initialState;
-    char initialStackSymbol;
+    Symbol initialStackSymbol;
     std::set<State> finalStates;
     std::vector<Transition> transitions;
+    std::map<State, std::vector<size_t>> transitionsByState; // Dispatch buckets: indices into transitions by source state
+    std::vector<size_t>* attemptCounts; // Per transition: times the search applied it (profiling only)
 
     // Acceptance criteria
     bool useFinalStateAcceptance; // true for APf, false for APv (stack-empty acceptance)
@@ -29,31 +34,76 @@ public:
 
     // Methods to build the PDA
     void addState(const std::string& stateName);
-    void addInputSymbol(char symbol);
-    void addStackSymbol(char symbol);
+    void addInputSymbol(Symbol symbol);
+    void addStackSymbol(Symbol symbol);
     void setInitialState(const std::string& stateName);
-    void setInitialStackSymbol(char symbol);
+    void setInitialStackSymbol(Symbol symbol);
     void addFinalState(const std::string& stateName);
-    void addTransition(const std::string& currentState, char inputSymbol, char stackSymbol,
-                       const std::string& nextState, const std::string& symbolsToPush);
-    std::set<char> getInputAlphabet() const;
-    std::set<State> getStates() const;
-    std::set<char> getStackAlphabet() const;
+    void addTransition(const std::string& currentState, Symbol inputSymbol, Symbol stackSymbol,
+                       const std::string& nextState, const SymbolString& symbolsToPush);
+    const std::set<Symbol>& getInputAlphabet() const;
+    const std::set<State>& getStates() const;
+    const std::set<Symbol>& getStackAlphabet() const;
     bool getUseFinalStateAcceptance() const;
+    const State& getInitialState() const;
+    Symbol getInitialStackSymbol() const;
+    const std::set<State>& getFinalStates() const;
+    const std::vector<Transition>& getTransitions() const;
+    size_t getTransitionCount() const;
+
+    // Profile-guided ordering of the dispatch buckets (see TransitionProfile)
+    void reorderTransitions(const std::vector<size_t>& successCounts, const std::vector<size_t>& attemptCounts);
+    void setAttemptCounts(std::vector<size_t>* attemptCounts); // nullptr stops counting
+    // Indices of the transitions leaving state, in the order the search tries them
+    const std::vector<size_t>& getDispatchOrder(const State& state) const;
 
     // Processing input strings
-    bool processInput(const std::string& input);
-    bool processInputTrace(const std::string& input, const std::string& outputMode);
+    bool processInput(const SymbolString& input);
+    Verdict processInput(const SymbolString& input, const SearchBudget& budget, SearchStats& stats);
+    Verdict processInputWitness(const SymbolString& input, const SearchBudget& budget, SearchStats& stats,
+                                std::vector<size_t>& witness);
+    bool processInputTrace(const SymbolString& input, const std::string& outputMode);
+
+    // Accepting-path witnesses (indices of transitions in definition order)
+    bool processInputWitness(const SymbolString& input, std::vector<size_t>& witness);
+    bool checkWitness(const SymbolString& input, const std::vector<size_t>& witness) const;
 
+    // Configuration-set simulation (all nondeterministic branches advanced in lockstep)
+    Configuration getInitialConfiguration() const;
+    bool isAccepting(const Configuration& configuration) const;
+    bool isAccepting(const std::set<Configuration>& configurations) const;
+    std::set<Configuration> epsilonClosure(const std::set<Configuration>& configurations,
+                                           size_t maxStackHeight = 0, bool* truncated = nullptr) const;
+    std::set<Configuration> step(const std::set<Configuration>& configurations, Symbol inputSymbol) const;
 
 
 private:
+    // Pending configuration of the budgeted search, which keeps its own stack of frames
+    struct SearchFrame {
+      State state;
+      size_t position; // Symbols of the input consumed
+      Stack stack;
+      size_t transition; // Index of the transition that led here
+      std::vector<size_t> candidates;
+      size_t nextCandidate;
+      bool expanded;
+      size_t memoryInUse; // Memory held by the frames below
+      size_t frameMemory;
+    };
+
     // Helper methods
-    bool processRecursive(const State& currentState, const std::string& remainingInput, Stack& stack);
-    bool processRecursiveTrace(const State& currentState, const std::string& remainingInput, Stack& stack,
+    bool processRecursive(const State& currentState, const SymbolString& remainingInput, Stack& stack,
+                          std::vector<size_t>& path);
+    Verdict processBudgeted(const SymbolString& input, const SearchBudget& budget, SearchStats& stats,
+                            std::vector<size_t>* witness);
+    bool processRecursiveTrace(const State& currentState, const SymbolString& remainingInput, Stack& stack,
                                std::string& trace, int depth = 0);
 
-    std::vector<Transition> getPossibleTransitions(const State& state, char inputSymbol, char stackSymbol);
+    std::vector<Transition> getPossibleTransitions(const State& state, Symbol inputSymbol, Symbol stackSymbol);
+    std::vector<size_t> getPossibleTransitionIndices(const State& state, Symbol inputSymbol, Symbol stackSymbol) const;
+    static bool exceedsBudget(const SearchBudget& budget, SearchStats& stats,
+                              const std::chrono::steady_clock::time_point& start, size_t stackHeight);
+    static bool applyStackOperation(const Transition& transition, Stack& stack);
 };
 
 #endif // PDA_H
@@ -0,0 +1,84 @@
+#ifndef PDASESSION_H
+#define PDASESSION_H
+
+#include <set>
+#include <string>
+#include <memory>
+#include "PDA.h"
+
+// Online recognition of a stream fed one symbol at a time. The session keeps the epsilon-closed
+// set of live configurations, so each symbol costs one step over that set instead of a new
+// search over the whole prefix. Configurations from which no continuation can be accepted are
+// discarded as they appear (see ViabilityAutomaton), so the set empties exactly when the prefix
+// is dead.
+//
+// Stacks are interned as shared cells (a symbol over the cell below it), so a step pushes or pops
+// without copying the stack, and every cell records the states from which it can still accept:
+// the cost of a symbol does not grow with the length of the prefix. Cells are reference-counted
+// and freed once no configuration, snapshot or fork holds them, so memory follows the live
+// configurations rather than the length of the stream. The set of configurations is never
+// modified in place: feed() replaces it, so snapshot() and fork() only share a pointer and the
+// copies evolve independently. Forks share the interned cells and are not thread-safe.
+class PDASession {
+  public:
+    enum Status {
+      ACCEPT,        // The symbols fed so far are accepted
+      VIABLE_PREFIX, // Not accepted, but some continuation is
+      DEAD           // No continuation is accepted
+    };
+
+  private:
+    struct Cell {
+      ~Cell();
+
+      Symbol symbol;
+      std::shared_ptr<Cell> below; // nullptr at the bottom
+      size_t height;
+      std::vector<bool> viable; // Per state: (state, this stack) can still accept
+    };
+    struct Engine;
+    typedef std::shared_ptr<Cell> CellPointer;
+    typedef std::pair<size_t, CellPointer> Live; // (state, stack)
+    typedef std::shared_ptr<const std::set<Live> > LiveSet;
+
+  public:
+    // Saved point of a session, brought back with restore() on it or on one of its forks
+    class Snapshot {
+      friend class PDASession;
+      LiveSet configurations;
+      size_t position;
+      bool truncated;
+    };
+
+    // maxStackHeight bounds the stack of the live configurations. With 0 the stack is unbounded
+    // unless an epsilon cycle can grow it, in which case AutomatonAnalyzer's default bound keeps
+    // the epsilon closures finite and isTruncated() reports when it discards a configuration
+    PDASession(const PDA& pda, size_t maxStackHeight = 0);
+
+    Status feed(Symbol symbol);
+    Status feed(const SymbolString& symbols);
+    Status status() const;
+
+    Snapshot snapshot() const;
+    void restore(const Snapshot& snapshot);
+    PDASession fork() const;
+
+    size_t getPosition() const; // Symbols fed so far
+    size_t getConfigurationCount() const;
+    size_t getCellCount() const; // Stack cells currently held by this session and its forks
+    // True if the stack bound discarded a configuration that could still accept, so a DEAD or
+    // VIABLE_PREFIX status may be wrong
+    bool isTruncated() const;
+
+    static std::string toString(Status status);
+
+  private:
+    LiveSet viableClosure(std::set<Live> configurations);
+
+    std::shared_ptr<Engine> engine; // Shared by every fork
+    LiveSet configurations;
+    size_t position;
+    bool truncated;
+};
+
+#endif // PDASESSION_H
@@ -0,0 +1,48 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include "PDA.h"
+#include "SearchBudget.h"
+
+// Cache of verdicts keyed by the input, hashed with 64-bit FNV-1a and compared in full, so a hash
+// collision never returns the verdict of another input. It removes repeated work within a run
+// and, saved to disk together with the fingerprint of the automaton, across runs: a cache file
+// is only reused while the normalized automaton definition is unchanged.
+class ResultCache {
+  public:
+    ResultCache(uint64_t fingerprint);
+
+    // Hash of the normalized definition and the symbol width (PDA_SYMBOL_BITS): states, alphabets
+    // and transitions are sorted, so reordering the lines of a definition file does not
+    // invalidate the cache
+    static uint64_t fingerprint(const PDA& pda);
+    static uint64_t hashInput(const SymbolString& input);
+
+    bool lookup(const SymbolString& input, Verdict& verdict);
+    // Only decided verdicts are stored; Unknown depends on the budget
+    void store(const SymbolString& input, Verdict verdict);
+
+    // Loading a file written for another automaton leaves the cache empty. A malformed file is
+    // reported and ignored as a whole.
+    bool load(const std::string& filename);
+    bool save(const std::string& filename) const;
+
+    size_t getHits() const;
+    size_t getSize() const;
+
+  private:
+    struct InputHash {
+      size_t operator()(const SymbolString& input) const {
+        return static_cast<size_t>(ResultCache::hashInput(input));
+      }
+    };
+
+    uint64_t automatonFingerprint;
+    std::unordered_map<SymbolString, bool, InputHash> verdicts; // Input -> accepted
+    size_t hits;
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,50 @@
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <string>
+#include <ostream>
+#include <chrono>
+#include "SearchBudget.h"
+#include "Symbol.h"
+
+// Output formats for the per-input results
+enum class OutputFormat {
+  Text,     // "Processing input: ..." / "Result: ..." blocks (default)
+  Compact,  // "<index> <verdict>[ <details>]", one line per input
+  Csv,      // "index,verdict,details" header and one row per input
+  JsonLines // {"index":<index>,"verdict":"<verdict>"[,"details":"<details>"]} per line
+};
+
+// Writes results through a large in-memory buffer, so high-volume batches issue a few big
+// writes instead of several small formatted writes per input. Also keeps the counts for the
+// end-of-run summary.
+class ResultWriter {
+  public:
+    ResultWriter(std::ostream& out, OutputFormat format);
+    ~ResultWriter();
+
+    static bool parseFormat(const std::string& name, OutputFormat& format);
+
+    // Text format echoes the input before its result; other formats ignore this call
+    void beginInput(const SymbolString& input);
+    // Details are extra lines (witness, count, prefix status, stats). The text format prints them
+    // as given; the other formats put them on the result line, with the lines joined by "; "
+    void writeResult(size_t index, Verdict verdict, const std::string& details = "");
+    void flush();
+
+    // Accept, reject and unknown counts, elapsed time and throughput
+    void writeSummary(std::ostream& out);
+
+  private:
+    static const size_t BUFFER_LIMIT = 1 << 20;
+
+    std::ostream& out;
+    OutputFormat format;
+    std::string buffer;
+    size_t accepted;
+    size_t rejected;
+    size_t unknown;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // RESULTWRITER_H
@@ -0,0 +1,53 @@
+#ifndef SEARCHBUDGET_H
+#define SEARCHBUDGET_H
+
+#include <string>
+#include <cstddef>
+
+// Outcome of a (possibly budgeted) search
+enum class Verdict {
+  Accepted,
+  Rejected,
+  Unknown // A budget ran out before the search could decide
+};
+
+// Per-input limits for the search. A limit of 0 means unlimited.
+class SearchBudget {
+  public:
+    SearchBudget();
+
+    void setMaxConfigurations(size_t maxConfigurations);
+    void setMaxMilliseconds(size_t maxMilliseconds);
+    void setMaxStackHeight(size_t maxStackHeight);
+    void setMaxMemoryBytes(size_t maxMemoryBytes);
+
+    size_t getMaxConfigurations() const;
+    size_t getMaxMilliseconds() const;
+    size_t getMaxStackHeight() const;
+    size_t getMaxMemoryBytes() const;
+
+    // True if at least one limit is set
+    bool isLimited() const;
+
+  private:
+    size_t maxConfigurations;
+    size_t maxMilliseconds;
+    size_t maxStackHeight;
+    size_t maxMemoryBytes;
+};
+
+// Statistics reached by a budgeted search
+class SearchStats {
+  public:
+    SearchStats();
+
+    size_t configurationsExplored;
+    size_t maxStackHeight;
+    size_t elapsedMilliseconds;
+    size_t peakMemoryBytes;
+    std::string exceededBudget; // Name of the limit that stopped the search, empty if none
+
+    std::string toString() const;
+};
+
+#endif // SEARCHBUDGET_H
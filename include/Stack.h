@@ -4,18 +4,25 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include "Symbol.h"
 
 class Stack {
 private:
-  std::vector<char> stackContainer;
+  std::vector<Symbol> stackContainer;
 
 public:
-  Stack(char initialSymbol);
-  void push(const std::string& symbols);
-  char pop();
-  char peek() const;
+  Stack(Symbol initialSymbol);
+  void push(const SymbolString& symbols);
+  Symbol pop();
+  Symbol peek() const;
   bool isEmpty() const;
+  size_t size() const;
+  const std::vector<Symbol>& getContents() const; // Bottom first
   std::string display() const;
+
+  // Overloaded operators for comparison (needed for use in sets of configurations)
+  bool operator<(const Stack& other) const;
+  bool operator==(const Stack& other) const;
 };
 
 #endif // STACK_H
@@ -0,0 +1,53 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <string>
+#include <cstdint>
+
+// Input and stack symbols. Their width is fixed at compile time with PDA_SYMBOL_BITS
+// (make SYMBOL_BITS=16): 8-bit builds use plain char, so inputs are read and printed byte for
+// byte; 16 and 32-bit builds raise the alphabet limit to 2^16 - 1 and 2^32 - 1 symbols, which is
+// what token streams coming from a lexer need. The value 0 is reserved for epsilon in every width.
+#ifndef PDA_SYMBOL_BITS
+#define PDA_SYMBOL_BITS 8
+#endif
+
+#if PDA_SYMBOL_BITS == 8
+typedef char Symbol;
+#elif PDA_SYMBOL_BITS == 16
+typedef char16_t Symbol;
+#elif PDA_SYMBOL_BITS == 32
+typedef char32_t Symbol;
+#else
+#error "PDA_SYMBOL_BITS must be 8, 16 or 32"
+#endif
+
+typedef std::basic_string<Symbol> SymbolString;
+
+// Largest symbol value
+const uint32_t MAX_SYMBOL_VALUE = static_cast<uint32_t>((uint64_t(1) << PDA_SYMBOL_BITS) - 1);
+
+// Numeric value of a symbol (0 .. MAX_SYMBOL_VALUE). Inline: it sits in the per-symbol loops.
+inline uint32_t symbolValue(Symbol symbol) {
+#if PDA_SYMBOL_BITS == 8
+  return static_cast<unsigned char>(symbol);
+#else
+  return static_cast<uint32_t>(symbol);
+#endif
+}
+
+// Text form of a symbol. 8-bit builds print the byte itself; wider builds print printable ASCII
+// symbols as themselves and any other symbol in the numeric notation <NNN>.
+std::string symbolToText(Symbol symbol);
+std::string symbolsToText(const SymbolString& symbols);
+void appendSymbols(std::string& text, const SymbolString& symbols);
+
+// Byte string as symbols, one symbol per byte
+SymbolString textToSymbols(const std::string& text);
+
+// Reads one symbol of a definition file starting at text[position]: either a single byte or the
+// numeric notation <NNN> (1 .. MAX_SYMBOL_VALUE) and advances position past it. Returns false
+// for a <NNN> group out of range.
+bool parseSymbol(const char* text, size_t length, size_t& position, Symbol& symbol);
+
+#endif // SYMBOL_H
@@ -3,28 +3,29 @@
 
 #include <string>
 #include "State.h"
+#include "Symbol.h"
 
 class Transition {
   public:
     Transition(const State& currentState,
-               char inputSymbol,
-               char stackSymbol,
+               Symbol inputSymbol,
+               Symbol stackSymbol,
                const State& nextState,
-               const std::string& symbolsToPush);
+               const SymbolString& symbolsToPush);
 
     State getCurrentState() const;
-    char getInputSymbol() const;
-    char getStackSymbol() const;
+    Symbol getInputSymbol() const;
+    Symbol getStackSymbol() const;
     State getNextState() const;
-    std::string getSymbolsToPush() const;
+    SymbolString getSymbolsToPush() const;
 
 
     private:
       State currentState;
-      char inputSymbol;
-      char stackSymbol;
+      Symbol inputSymbol;
+      Symbol stackSymbol;
       State nextState;
-      std::string symbolsToPush;
+      SymbolString symbolsToPush;
 };
 
 #endif // TRANSITION_H
\ No newline at end of file
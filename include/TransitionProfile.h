@@ -0,0 +1,37 @@
+#ifndef TRANSITIONPROFILE_H
+#define TRANSITIONPROFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Counts, over a training corpus, how often the search tries each transition and how often it
+// lies on an accepting path. The profile can be saved, loaded in later runs and applied with
+// PDA::reorderTransitions, which orders by success rate (successes / attempts). The file keeps
+// the fingerprint of the automaton (ResultCache::fingerprint), so a profile recorded for another
+// automaton is rejected even if it has as many transitions.
+class TransitionProfile {
+  public:
+    TransitionProfile(size_t transitionCount = 0, uint64_t fingerprint = 0);
+
+    // Adds the transitions of an accepting witness to the counts
+    void record(const std::vector<size_t>& witness);
+
+    const std::vector<size_t>& getSuccessCounts() const;
+    // Filled by the search while the vector is set with PDA::setAttemptCounts
+    std::vector<size_t>& getAttemptCounts();
+    const std::vector<size_t>& getAttemptCounts() const;
+    size_t getAcceptedInputs() const;
+
+    bool save(const std::string& filename) const;
+    // Fails if the file was written for another transition count or fingerprint than this profile's
+    bool load(const std::string& filename);
+
+  private:
+    uint64_t automatonFingerprint;
+    std::vector<size_t> successCounts;
+    std::vector<size_t> attemptCounts;
+    size_t acceptedInputs;
+};
+
+#endif // TRANSITIONPROFILE_H
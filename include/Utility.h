@@ -12,14 +12,63 @@ void displayHelp() {
     std::cout << "                        none       : Regular execution mode (default).\n";
     std::cout << "                        trace      : Trace mode, output to console.\n";
     std::cout << "                        tracefile  : Trace mode, output to specified file.\n";
+    std::cout << "                        trie       : Batch mode, inputs sharing a prefix are simulated once.\n";
+    std::cout << "                        witness    : Print the transitions (0-based, in definition order)\n";
+    std::cout << "                                     along the accepting path of each accepted input.\n";
+    std::cout << "                        count      : Count the accepting computations of each input\n";
+    std::cout << "                                     (ambiguity) with a polynomial-time dynamic program.\n";
+    std::cout << "                        online     : Feed each input symbol by symbol and report the first\n";
+    std::cout << "                                     position where no continuation can be accepted.\n";
+    std::cout << "                        analyze    : Report nondeterminism, epsilon cycles and the expected\n";
+    std::cout << "                                     cost of the search (no input strings file is needed).\n";
+    std::cout << "                        enumerate  : Write every accepted string of length up to --length\n";
+    std::cout << "                                     (no input strings file is needed).\n";
+    std::cout << "                        sample     : Write --count accepted strings of length up to --length,\n";
+    std::cout << "                                     drawn uniformly (no input strings file is needed).\n";
     std::cout << "  -o, --output <file>   Specify the output file for trace mode.\n";
+    std::cout << "  -f, --format <format> Result output format:\n";
+    std::cout << "                        text       : 'Processing input' / 'Result' blocks (default).\n";
+    std::cout << "                        compact    : '<index> <verdict>' per line.\n";
+    std::cout << "                        csv        : 'index,verdict' rows.\n";
+    std::cout << "                        jsonl      : One JSON object per line.\n";
+    std::cout << "  -q, --quiet           Same as --format compact.\n";
+    std::cout << "  --cache <file>        Load verdicts from and save them to a cache file (modes none\n";
+    std::cout << "                        and trie). It is only reused while the automaton is unchanged.\n";
+    std::cout << "  --summary             Print accept/reject counts and throughput to stderr at the end.\n";
     std::cout << "  -a, --acceptance <type> Specify acceptance criteria. Available types:\n";
     std::cout << "                        apf        : Acceptance by final state (default).\n";
     std::cout << "                        apv        : Acceptance by empty stack.\n";
+    std::cout << "  --profile-out <file>  Record how often each transition is tried and lies on an accepting\n";
+    std::cout << "                        path (modes none and witness) and save the profile to a file.\n";
+    std::cout << "  --profile-in <file>   Load a profile and try the transitions with the highest success\n";
+    std::cout << "                        rate first.\n";
+    std::cout << "  --no-counter          Do not run counter-stack automata on the integer-counter engine.\n";
+    std::cout << "  --parikh <constraint> Necessary condition on symbol counts checked before searching,\n";
+    std::cout << "                        e.g. a=b, a<=b, c>0 (can be repeated). Inputs with symbols no\n";
+    std::cout << "                        transition reads are always rejected by this pre-pass.\n";
+    std::cout << "  --tokens              Each input line is a whitespace-separated list of numeric token ids\n";
+    std::cout << "                        (symbols written <NNN> in the definition).\n";
+    std::cout << "  --length <n>          Maximum length of generated strings (default 10).\n";
+    std::cout << "  --count <n>           Strings to generate (enumerate: all by default, sample: 1).\n";
+    std::cout << "  --seed <n>            Random seed for sample mode (default 0).\n";
+    std::cout << "  --max-steps <n>       Per-input limit on the configurations explored.\n";
+    std::cout << "  --max-time <ms>       Per-input wall-clock limit in milliseconds.\n";
+    std::cout << "  --max-stack <n>       Per-input limit on the stack height (also honoured by trie, online,\n";
+    std::cout << "                        enumerate and sample modes).\n";
+    std::cout << "  --max-memory <bytes>  Per-input limit on the memory held by the search.\n";
+    std::cout << "                        When a limit runs out the input is reported as Unknown. The limits\n";
+    std::cout << "                        apply to modes none and witness; other modes reject them.\n";
     std::cout << "\nExamples:\n";
     std::cout << "  pda_simulator -m trace automaton.txt input.txt\n";
     std::cout << "  pda_simulator -m tracefile -o trace_output.txt automaton.txt input.txt\n";
     std::cout << "  pda_simulator -a apv automaton.txt input.txt\n";
+    std::cout << "  pda_simulator -m trie automaton.txt input.txt\n";
+    std::cout << "  pda_simulator --profile-out profile.txt automaton.txt training.txt\n";
+    std::cout << "  pda_simulator --profile-in profile.txt automaton.txt input.txt\n";
+    std::cout << "  pda_simulator -q --summary automaton.txt input.txt\n";
+    std::cout << "  pda_simulator --parikh a=b automaton.txt input.txt\n";
+    std::cout << "  pda_simulator -m sample --length 40 --count 1000000 --seed 7 automaton.txt\n";
+    std::cout << "  pda_simulator --max-steps 100000 --max-time 500 automaton.txt input.txt\n";
     std::cout << "\n";
 }
 
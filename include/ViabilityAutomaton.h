@@ -0,0 +1,59 @@
+#ifndef VIABILITYAUTOMATON_H
+#define VIABILITYAUTOMATON_H
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "PDA.h"
+#include "Configuration.h"
+
+// Recognizes the configurations from which an accepting configuration can still be reached by
+// reading some continuation of the input (the set pre* of the accepting configurations). It is a
+// finite automaton that reads the stack from the top down to a bottom marker, starting at the
+// control state of the configuration (Bouajjani, Esparza and Maler), built by saturation as in
+// Schwoon's algorithm: for every rule (p, X) -> (q, w), whenever q can read w and reach s, the
+// edge p -X-> s is added. Rules pushing more than two symbols are split into chains through fresh
+// states, and a transition that does not look at the stack becomes one rule per stack symbol plus
+// one for the bottom marker. Input symbols play no part in viability: any continuation may be read.
+//
+// Edges are weighted with the fewest input symbols read along the way (the shortest-path
+// semiring of weighted pushdown systems), so the automaton also gives the length of the shortest
+// accepted continuation. Weights are clamped at maxDistance + 1, which bounds the number of times
+// saturation can improve an edge: distances up to maxDistance are exact and longer ones read as
+// maxDistance + 1. With the default of 0 it only answers viability.
+class ViabilityAutomaton {
+  public:
+    static const size_t UNREACHABLE;
+
+    ViabilityAutomaton(const PDA& pda, size_t maxDistance = 0);
+
+    // True if some continuation of the input leads from the configuration to acceptance
+    bool isViable(const Configuration& configuration) const;
+    // Length of the shortest such continuation (maxDistance + 1 if longer, UNREACHABLE if none)
+    size_t distance(const Configuration& configuration) const;
+
+    // The same question answered bottom-up, for stacks built one symbol at a time: the control
+    // states (numbered by getStateIndex) that can still accept over the empty stack, and over
+    // top pushed on a stack whose answer is below. Each call costs one pass over the edges of top.
+    std::vector<bool> viableOnEmptyStack() const;
+    std::vector<bool> viableOnPush(Symbol top, const std::vector<bool>& below) const;
+
+    size_t getStateIndex(const State& state) const;
+    size_t getEdgeCount() const;
+
+  private:
+    typedef std::pair<size_t, size_t> WeightedTarget; // (target, weight)
+
+    size_t key(size_t state, size_t symbol) const;
+
+    std::map<State, size_t> stateIndex;
+    std::unordered_map<Symbol, size_t> symbolIndex;
+    size_t symbolCount;  // Stack symbols plus the bottom marker (the last one)
+    size_t acceptAny;    // Reads any stack: final state reached under APf
+    size_t end;          // Reached after the bottom marker
+    size_t maxWeight;    // maxDistance + 1
+    std::vector<std::vector<WeightedTarget> > successors; // Per (state, symbol) of the control states, acceptAny and end
+    size_t edgeCount;
+};
+
+#endif // VIABILITYAUTOMATON_H
@@ -0,0 +1,357 @@
+#include "../include/AutomatonAnalyzer.h"
+#include <map>
+#include <algorithm>
+
+// Text of a transition field, '.' for epsilon
+static std::string fieldText(Symbol symbol) {
+  return symbol == '\0' ? "." : symbolToText(symbol);
+}
+
+AutomatonAnalyzer::AutomatonAnalyzer(const PDA& pda)
+  : pda(pda),
+    risk(LINEAR),
+    maxBranching(0),
+    maxBranchingOnCycle(0) {
+  std::map<State, size_t> stateIndex;
+  for (const auto& state : pda.getStates()) {
+    size_t index = stateIndex.size();
+    stateIndex[state] = index;
+    stateNames.push_back(state.getName());
+  }
+  const std::vector<Transition>& transitions = pda.getTransitions();
+  for (const auto& transition : transitions) {
+    sourceState.push_back(stateIndex[transition.getCurrentState()]);
+    targetState.push_back(stateIndex[transition.getNextState()]);
+  }
+
+  // Transitions per (input symbol, stack symbol) of each state
+  std::vector<std::map<std::pair<Symbol, Symbol>, size_t> > counts(stateNames.size());
+  for (size_t t = 0; t < transitions.size(); ++t) {
+    counts[sourceState[t]][std::make_pair(transitions[t].getInputSymbol(), transitions[t].getStackSymbol())]++;
+  }
+  auto count = [&counts](size_t state, Symbol input, Symbol top) {
+    auto entry = counts[state].find(std::make_pair(input, top));
+    return entry == counts[state].end() ? size_t(0) : entry->second;
+  };
+
+  // The depth-first search tries, once each, the transitions of the state that read the current
+  // symbol or no input; a stack-epsilon transition matches any top
+  std::vector<Symbol> tops(pda.getStackAlphabet().begin(), pda.getStackAlphabet().end());
+  tops.push_back('\0');
+  for (size_t state = 0; state < stateNames.size(); ++state) {
+    if (counts[state].empty()) {
+      continue;
+    }
+    for (Symbol top : tops) {
+      Branching branching;
+      branching.state = state;
+      branching.top = top;
+      branching.endOfInput = count(state, '\0', '\0') + (top != '\0' ? count(state, '\0', top) : 0);
+      branching.maxBranching = branching.endOfInput;
+      branching.worstSymbol = '\0';
+      for (Symbol input : pda.getInputAlphabet()) {
+        size_t reading = count(state, input, '\0') + (top != '\0' ? count(state, input, top) : 0);
+        if (reading == 0) {
+          continue;
+        }
+        branching.inputSymbols += (branching.inputSymbols.empty() ? "" : " ") + symbolToText(input);
+        if (reading + branching.endOfInput > branching.maxBranching) {
+          branching.maxBranching = reading + branching.endOfInput;
+          branching.worstSymbol = input;
+        }
+      }
+      if (branching.maxBranching == 0) {
+        continue;
+      }
+      branching.overlapsEpsilon = branching.endOfInput > 0 && !branching.inputSymbols.empty();
+      maxBranching = std::max(maxBranching, branching.maxBranching);
+      branchings.push_back(branching);
+    }
+  }
+
+  // States on a cycle of the transition graph, where a choice can be repeated once per symbol
+  std::vector<std::vector<size_t> > successors(stateNames.size());
+  std::vector<std::vector<size_t> > epsilonSuccessors(stateNames.size());
+  for (size_t t = 0; t < transitions.size(); ++t) {
+    successors[sourceState[t]].push_back(targetState[t]);
+    if (transitions[t].getInputSymbol() == '\0') {
+      epsilonSuccessors[sourceState[t]].push_back(targetState[t]);
+      if (stackEffect(transitions[t]) > 0) {
+        growingEpsilonTransitions.push_back(t);
+      }
+    }
+  }
+  onCycle.assign(stateNames.size(), false);
+  for (const auto& component : stronglyConnectedComponents(successors)) {
+    for (size_t state : component) {
+      onCycle[state] = component.size() > 1 ||
+        std::find(successors[state].begin(), successors[state].end(), state) != successors[state].end();
+    }
+  }
+  for (const auto& branching : branchings) {
+    if (onCycle[branching.state]) {
+      maxBranchingOnCycle = std::max(maxBranchingOnCycle, branching.maxBranching);
+    }
+  }
+
+  // Epsilon cycles, weighted by the net stack change of each transition (the stack tops are not
+  // checked). Bellman-Ford longest paths find a cycle that grows the stack; without one, the
+  // distances are consistent and a cycle made only of tight edges (d[u] + w = d[v]) is one that
+  // leaves the stack height unchanged.
+  std::vector<size_t> component(stateNames.size());
+  std::vector<std::vector<size_t> > epsilonComponents = stronglyConnectedComponents(epsilonSuccessors);
+  for (size_t c = 0; c < epsilonComponents.size(); ++c) {
+    for (size_t state : epsilonComponents[c]) {
+      component[state] = c;
+    }
+  }
+  std::vector<std::vector<size_t> > componentTransitions(epsilonComponents.size());
+  for (size_t t = 0; t < transitions.size(); ++t) {
+    if (transitions[t].getInputSymbol() == '\0' && component[sourceState[t]] == component[targetState[t]]) {
+      componentTransitions[component[sourceState[t]]].push_back(t);
+    }
+  }
+  std::vector<size_t> local(stateNames.size());
+  inEpsilonCycle.assign(transitions.size(), false);
+  for (size_t c = 0; c < epsilonComponents.size(); ++c) {
+    if (componentTransitions[c].empty()) {
+      continue; // A single state without an epsilon self-loop
+    }
+    EpsilonCycle cycle;
+    cycle.states = epsilonComponents[c];
+    cycle.transitions = componentTransitions[c];
+    std::sort(cycle.states.begin(), cycle.states.end());
+    for (size_t i = 0; i < cycle.states.size(); ++i) {
+      local[cycle.states[i]] = i;
+    }
+    for (size_t t : cycle.transitions) {
+      inEpsilonCycle[t] = true;
+    }
+
+    size_t size = cycle.states.size();
+    std::vector<long long> distance(size, 0);
+    bool relaxed = true;
+    for (size_t round = 0; round <= size && relaxed; ++round) {
+      relaxed = false;
+      for (size_t t : cycle.transitions) {
+        long long candidate = distance[local[sourceState[t]]] + stackEffect(transitions[t]);
+        if (candidate > distance[local[targetState[t]]]) {
+          distance[local[targetState[t]]] = candidate;
+          relaxed = true;
+        }
+      }
+    }
+    if (relaxed) {
+      cycle.trend = 1;
+    }
+    else {
+      std::vector<std::vector<size_t> > tight(size);
+      for (size_t t : cycle.transitions) {
+        size_t from = local[sourceState[t]];
+        size_t to = local[targetState[t]];
+        if (distance[from] + stackEffect(transitions[t]) == distance[to]) {
+          tight[from].push_back(to);
+        }
+      }
+      cycle.trend = -1;
+      for (const auto& tightComponent : stronglyConnectedComponents(tight)) {
+        size_t state = tightComponent[0];
+        if (tightComponent.size() > 1 || std::find(tight[state].begin(), tight[state].end(), state) != tight[state].end()) {
+          cycle.trend = 0;
+        }
+      }
+    }
+    if (cycle.trend >= 0) {
+      risk = NON_TERMINATING;
+    }
+    epsilonCycles.push_back(cycle);
+  }
+
+  if (risk != NON_TERMINATING) {
+    risk = maxBranchingOnCycle > 1 ? EXPONENTIAL : maxBranching > 1 ? BOUNDED : LINEAR;
+  }
+}
+
+// Tarjan's algorithm, iterative so that long chains of states do not exhaust the call stack
+std::vector<std::vector<size_t> > AutomatonAnalyzer::stronglyConnectedComponents(
+  const std::vector<std::vector<size_t> >& successors) {
+  const size_t UNVISITED = static_cast<size_t>(-1);
+  size_t count = successors.size();
+  std::vector<size_t> index(count, UNVISITED);
+  std::vector<size_t> lowLink(count, 0);
+  std::vector<bool> onStack(count, false);
+  std::vector<size_t> stack;
+  std::vector<std::vector<size_t> > components;
+  size_t nextIndex = 0;
+
+  for (size_t root = 0; root < count; ++root) {
+    if (index[root] != UNVISITED) {
+      continue;
+    }
+    std::vector<std::pair<size_t, size_t> > frames(1, std::make_pair(root, size_t(0)));
+    index[root] = lowLink[root] = nextIndex++;
+    stack.push_back(root);
+    onStack[root] = true;
+    while (!frames.empty()) {
+      size_t node = frames.back().first;
+      size_t& edge = frames.back().second;
+      if (edge < successors[node].size()) {
+        size_t next = successors[node][edge++];
+        if (index[next] == UNVISITED) {
+          index[next] = lowLink[next] = nextIndex++;
+          stack.push_back(next);
+          onStack[next] = true;
+          frames.push_back(std::make_pair(next, size_t(0)));
+        }
+        else if (onStack[next]) {
+          lowLink[node] = std::min(lowLink[node], index[next]);
+        }
+        continue;
+      }
+      if (lowLink[node] == index[node]) {
+        std::vector<size_t> component;
+        size_t member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          onStack[member] = false;
+          component.push_back(member);
+        } while (member != node);
+        components.push_back(component);
+      }
+      frames.pop_back();
+      if (!frames.empty()) {
+        size_t parent = frames.back().first;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+      }
+    }
+  }
+  return components;
+}
+
+// Net change of the stack height
+long long AutomatonAnalyzer::stackEffect(const Transition& transition) {
+  return static_cast<long long>(transition.getSymbolsToPush().size()) - (transition.getStackSymbol() != '\0' ? 1 : 0);
+}
+
+// "#index" followed by the transition as written in the definition file
+std::string AutomatonAnalyzer::describe(size_t transition) const {
+  const Transition& t = pda.getTransitions()[transition];
+  SymbolString pushed = t.getSymbolsToPush();
+  return "#" + std::to_string(transition) + " " + t.getCurrentState().getName() + " " + fieldText(t.getInputSymbol()) +
+    " " + fieldText(t.getStackSymbol()) + " " + t.getNextState().getName() + " " +
+    (pushed.empty() ? "." : symbolsToText(pushed));
+}
+
+void AutomatonAnalyzer::writeReport(std::ostream& out) const {
+  out << "Automaton: " << stateNames.size() << " states, " << pda.getTransitionCount() << " transitions\n";
+
+  size_t nondeterministic = 0;
+  out << "\nBranching per (state, stack top) [candidates for the worst input symbol / at end of input]:\n";
+  for (const auto& branching : branchings) {
+    if (branching.maxBranching > 1) {
+      nondeterministic++;
+    }
+    out << "  " << stateNames[branching.state] << ", " << (branching.top == '\0' ? "empty" : symbolToText(branching.top))
+        << ": " << branching.maxBranching;
+    if (branching.worstSymbol != '\0') {
+      out << " on " << symbolToText(branching.worstSymbol);
+    }
+    out << " / " << branching.endOfInput << (branching.maxBranching > 1 ? "  (nondeterministic)" : "") << "\n";
+  }
+  out << "  " << nondeterministic << " of " << branchings.size() << " pairs are nondeterministic, maximum branching "
+      << maxBranching << "\n";
+
+  out << "\nEpsilon cycles:\n";
+  if (epsilonCycles.empty()) {
+    out << "  none\n";
+  }
+  for (const auto& cycle : epsilonCycles) {
+    out << "  states";
+    for (size_t state : cycle.states) {
+      out << " " << stateNames[state];
+    }
+    out << ", transitions";
+    for (size_t transition : cycle.transitions) {
+      out << " #" << transition;
+    }
+    if (cycle.trend > 0) {
+      out << ": the stack can grow without reading input";
+    }
+    else if (cycle.trend == 0) {
+      out << ": a turn can leave the stack height unchanged, so a configuration can repeat";
+    }
+    else {
+      out << ": every turn shrinks the stack";
+    }
+    out << "\n";
+  }
+
+  out << "\nEpsilon transitions that grow the stack:\n";
+  if (growingEpsilonTransitions.empty()) {
+    out << "  none\n";
+  }
+  for (size_t transition : growingEpsilonTransitions) {
+    out << "  " << describe(transition) << "  (+" << stackEffect(pda.getTransitions()[transition])
+        << (inEpsilonCycle[transition] ? ", on an epsilon cycle" : "") << ")\n";
+  }
+
+  out << "\nInput and epsilon transitions competing in the same (state, stack top):\n";
+  size_t overlaps = 0;
+  for (const auto& branching : branchings) {
+    if (branching.overlapsEpsilon) {
+      overlaps++;
+      out << "  " << stateNames[branching.state] << ", "
+          << (branching.top == '\0' ? "empty" : symbolToText(branching.top)) << ": reads " << branching.inputSymbols
+          << " and has " << branching.endOfInput << " epsilon move(s)\n";
+    }
+  }
+  if (overlaps == 0) {
+    out << "  none\n";
+  }
+
+  out << "\nEstimate for the depth-first search: ";
+  switch (risk) {
+    case NON_TERMINATING:
+      // Under any limit the search also stops at configurations already on its path, which ends a
+      // cycle that keeps the stack height, so --max-stack bounds both kinds of cycle
+      out << "may not terminate. An epsilon cycle does not shrink the stack, so the search can follow it "
+          << "forever; bound it with --max-steps, --max-time, --max-memory or --max-stack.\n";
+      break;
+    case EXPONENTIAL:
+      out << "exponential. A state on a cycle has " << maxBranchingOnCycle << " candidate transitions, so an input of "
+          << "length n can lead to up to " << maxBranchingOnCycle << "^n paths; prefer the trie mode or a budget.\n";
+      break;
+    case BOUNDED:
+      out << "bounded. There are choices (up to " << maxBranching << " candidates) but none on a cycle, so the "
+          << "number of paths does not grow with the input.\n";
+      break;
+    case LINEAR:
+      out << "linear. The automaton is deterministic: one path per input.\n";
+      break;
+  }
+}
+
+AutomatonAnalyzer::Risk AutomatonAnalyzer::getRisk() const {
+  return risk;
+}
+
+size_t AutomatonAnalyzer::getMaxBranching() const {
+  return maxBranching;
+}
+
+bool AutomatonAnalyzer::hasGrowingEpsilonCycle() const {
+  for (const auto& cycle : epsilonCycles) {
+    if (cycle.trend > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t AutomatonAnalyzer::closureStackBound(const PDA& pda, size_t maxStackHeight) {
+  if (maxStackHeight > 0) {
+    return maxStackHeight;
+  }
+  return AutomatonAnalyzer(pda).hasGrowingEpsilonCycle() ? DEFAULT_STACK_BOUND : 0;
+}
@@ -0,0 +1,111 @@
+#include "../include/BatchProcessor.h"
+#include "../include/AutomatonAnalyzer.h"
+#include <utility>
+
+BatchProcessor::BatchProcessor(const PDA& pda)
+  : pda(pda),
+    maxStackHeight(0),
+    trieNodeCount(0),
+    nodesVisited(0) {}
+
+std::vector<Verdict> BatchProcessor::processBatch(const std::vector<SymbolString>& inputs) {
+  // Build the trie, remembering where each input ends
+  InputTrie trie;
+  std::vector<size_t> terminalNodes;
+  terminalNodes.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    terminalNodes.push_back(trie.insert(input));
+  }
+  trieNodeCount = trie.getNodeCount();
+  nodesVisited = 0;
+
+  // Depth-first walk of the trie carrying the closed set of live configurations. A branch is
+  // marked truncated once the stack height limit has discarded any configuration on its path,
+  // so its rejections can no longer be trusted.
+  std::vector<Verdict> verdictAtNode(trie.getNodeCount(), Verdict::Rejected);
+  std::vector<PendingNode> pending;
+  size_t stackBound = AutomatonAnalyzer::closureStackBound(pda, maxStackHeight);
+
+  std::set<Configuration> initial;
+  initial.insert(pda.getInitialConfiguration());
+  PendingNode root;
+  root.node = InputTrie::ROOT;
+  root.truncated = false;
+  root.configurations = pda.epsilonClosure(initial, stackBound, &root.truncated);
+  pending.push_back(root);
+
+  while (!pending.empty()) {
+    PendingNode current = std::move(pending.back());
+    pending.pop_back();
+    nodesVisited++;
+
+    if (trie.isTerminal(current.node)) {
+      if (pda.isAccepting(current.configurations)) {
+        verdictAtNode[current.node] = Verdict::Accepted;
+      }
+      else if (current.truncated) {
+        verdictAtNode[current.node] = Verdict::Unknown;
+      }
+    }
+
+    for (const auto& child : trie.getChildren(current.node)) {
+      PendingNode next;
+      next.node = child.second;
+      next.truncated = current.truncated;
+      next.configurations = pda.step(current.configurations, child.first);
+      if (stackBound > 0) {
+        for (auto it = next.configurations.begin(); it != next.configurations.end();) {
+          if (it->getStack().size() > stackBound) {
+            it = next.configurations.erase(it);
+            next.truncated = true;
+          }
+          else {
+            ++it;
+          }
+        }
+      }
+      next.configurations = pda.epsilonClosure(next.configurations, stackBound, &next.truncated);
+
+      // Every input below a dead prefix is rejected (or unknown), so the subtree is only marked
+      if (next.configurations.empty()) {
+        if (next.truncated) {
+          markSubtree(trie, next.node, Verdict::Unknown, verdictAtNode);
+        }
+        continue;
+      }
+      pending.push_back(std::move(next));
+    }
+  }
+
+  std::vector<Verdict> results;
+  results.reserve(inputs.size());
+  for (size_t node : terminalNodes) {
+    results.push_back(verdictAtNode[node]);
+  }
+  return results;
+}
+
+void BatchProcessor::setMaxStackHeight(size_t maxStackHeight) {
+  this->maxStackHeight = maxStackHeight;
+}
+
+size_t BatchProcessor::getTrieNodeCount() const {
+  return trieNodeCount;
+}
+
+size_t BatchProcessor::getNodesVisited() const {
+  return nodesVisited;
+}
+
+void BatchProcessor::markSubtree(const InputTrie& trie, size_t node, Verdict verdict,
+                                 std::vector<Verdict>& verdictAtNode) {
+  std::vector<size_t> pendingNodes(1, node);
+  while (!pendingNodes.empty()) {
+    size_t current = pendingNodes.back();
+    pendingNodes.pop_back();
+    verdictAtNode[current] = verdict;
+    for (const auto& child : trie.getChildren(current)) {
+      pendingNodes.push_back(child.second);
+    }
+  }
+}
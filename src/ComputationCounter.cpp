@@ -0,0 +1,460 @@
+#include "../include/ComputationCounter.h"
+#include <map>
+#include <limits>
+#include <unordered_map>
+
+const uint64_t ComputationCounter::INFINITE = std::numeric_limits<uint64_t>::max();
+const uint64_t ComputationCounter::SATURATED = std::numeric_limits<uint64_t>::max() - 1;
+const size_t ComputationCounter::NONE = static_cast<size_t>(-1);
+
+ComputationCounter::ComputationCounter(const PDA& pda)
+  : useFinalStateAcceptance(pda.getUseFinalStateAcceptance()),
+    span(0) {
+  // Dense numbering of states and stack symbols
+  std::map<State, size_t> stateIndex;
+  for (const auto& state : pda.getStates()) {
+    size_t index = stateIndex.size();
+    stateIndex[state] = index;
+  }
+  std::map<Symbol, size_t> symbolIndex;
+  for (Symbol symbol : pda.getStackAlphabet()) {
+    size_t index = symbolIndex.size();
+    symbolIndex[symbol] = index;
+  }
+  stateCount = stateIndex.size();
+  symbolCount = symbolIndex.size();
+  initialState = stateIndex[pda.getInitialState()];
+  initialSymbol = symbolIndex[pda.getInitialStackSymbol()];
+  finalStates.assign(stateCount, false);
+  for (const auto& state : pda.getFinalStates()) {
+    finalStates[stateIndex[state]] = true;
+  }
+
+  // Pushed strings become linked lists of suffixes (pushed[0] ends on top)
+  auto addSuffixes = [&symbolIndex](std::vector<Suffix>& suffixes, const SymbolString& pushed) {
+    size_t next = NONE;
+    for (size_t l = pushed.size(); l > 0; --l) {
+      Suffix suffix;
+      suffix.symbol = symbolIndex[pushed[l - 1]];
+      suffix.next = next;
+      suffixes.push_back(suffix);
+      next = suffixes.size() - 1;
+    }
+    return next;
+  };
+
+  for (const auto& transition : pda.getTransitions()) {
+    size_t from = stateIndex[transition.getCurrentState()];
+    size_t to = stateIndex[transition.getNextState()];
+    const SymbolString pushed = transition.getSymbolsToPush();
+
+    if (transition.getStackSymbol() != '\0') {
+      PopTransition popTransition;
+      popTransition.from = from;
+      popTransition.inputSymbol = transition.getInputSymbol();
+      popTransition.popSymbol = symbolIndex[transition.getStackSymbol()];
+      popTransition.to = to;
+      popTransition.firstSuffix = addSuffixes(popSuffixes, pushed);
+      popTransitions.push_back(popTransition);
+      continue;
+    }
+
+    // Stack-epsilon: with X on top it behaves as popping X and pushing pushed + X
+    for (const auto& symbol : symbolIndex) {
+      PopTransition popTransition;
+      popTransition.from = from;
+      popTransition.inputSymbol = transition.getInputSymbol();
+      popTransition.popSymbol = symbol.second;
+      popTransition.to = to;
+      popTransition.firstSuffix = addSuffixes(popSuffixes, pushed + symbol.first);
+      popTransitions.push_back(popTransition);
+    }
+    EmptyTransition emptyTransition;
+    emptyTransition.from = from;
+    emptyTransition.inputSymbol = transition.getInputSymbol();
+    emptyTransition.to = to;
+    emptyTransition.firstSuffix = addSuffixes(emptySuffixes, pushed);
+    emptyTransitions.push_back(emptyTransition);
+  }
+}
+
+std::string ComputationCounter::toString(uint64_t count) {
+  if (count == INFINITE) {
+    return "infinite";
+  }
+  if (count == SATURATED) {
+    return "more than " + std::to_string(SATURATED - 1);
+  }
+  return std::to_string(count);
+}
+
+uint64_t ComputationCounter::add(uint64_t a, uint64_t b) {
+  if (a == INFINITE || b == INFINITE) {
+    return INFINITE;
+  }
+  uint64_t sum = a + b;
+  if (sum < a || sum >= SATURATED) {
+    return SATURATED;
+  }
+  return sum;
+}
+
+uint64_t ComputationCounter::multiply(uint64_t a, uint64_t b) {
+  if (a == 0 || b == 0) {
+    return 0;
+  }
+  if (a == INFINITE || b == INFINITE) {
+    return INFINITE;
+  }
+  if (a >= SATURATED / b) {
+    return SATURATED;
+  }
+  return a * b;
+}
+
+size_t ComputationCounter::indexOf(const Item& item) const {
+  switch (item.kind) {
+  case POP:
+    return offsets[POP] + (((item.a * symbolCount + item.b) * stateCount + item.c) * span + item.i) * span + item.j;
+  case POP_SUFFIX:
+    return offsets[POP_SUFFIX] + (((item.a * stateCount + item.b) * stateCount + item.c) * span + item.i) * span +
+           item.j;
+  case ACCEPT:
+    return offsets[ACCEPT] + (item.a * symbolCount + item.b) * span + item.i;
+  case ACCEPT_SUFFIX:
+    return offsets[ACCEPT_SUFFIX] + (item.a * stateCount + item.b) * span + item.i;
+  case EMPTY:
+    return offsets[EMPTY] + item.a * span + item.i;
+  case EMPTY_SUFFIX:
+    return offsets[EMPTY_SUFFIX] + (item.a * stateCount + item.b) * span + item.i;
+  }
+  return NONE;
+}
+
+// Calls callback(factor1, factor2) for every product term of the item's equation. Factors are
+// value indices, or NONE for the constant 1.
+template <typename Callback>
+void ComputationCounter::forEachTerm(const Item& item, Callback callback) const {
+  size_t length = input.size();
+  auto make = [](ItemKind kind, size_t a, size_t b, size_t c, size_t i, size_t j) {
+    Item made = { kind, a, b, c, i, j };
+    return made;
+  };
+  // Position after reading the transition's input symbol at i, or NONE if it does not match
+  auto advance = [this, length](Symbol inputSymbol, size_t i, size_t limit) {
+    if (inputSymbol == '\0') {
+      return i;
+    }
+    return (i < limit && i < length && input[i] == inputSymbol) ? i + 1 : NONE;
+  };
+
+  switch (item.kind) {
+  case POP:
+    for (const auto& transition : popTransitions) {
+      if (transition.from != item.a || transition.popSymbol != item.b) {
+        continue;
+      }
+      size_t next = advance(transition.inputSymbol, item.i, item.j);
+      if (next == NONE) {
+        continue;
+      }
+      if (transition.firstSuffix == NONE) {
+        if (transition.to == item.c && next == item.j) {
+          callback(NONE, NONE);
+        }
+      }
+      else {
+        callback(indexOf(make(POP_SUFFIX, transition.firstSuffix, transition.to, item.c, next, item.j)), NONE);
+      }
+    }
+    break;
+
+  case POP_SUFFIX: {
+    const Suffix& suffix = popSuffixes[item.a];
+    for (size_t middle = 0; middle < stateCount; ++middle) {
+      for (size_t k = item.i; k <= item.j; ++k) {
+        size_t popped = indexOf(make(POP, item.b, suffix.symbol, middle, item.i, k));
+        if (suffix.next == NONE) {
+          if (middle == item.c && k == item.j) {
+            callback(popped, NONE);
+          }
+        }
+        else {
+          callback(popped, indexOf(make(POP_SUFFIX, suffix.next, middle, item.c, k, item.j)));
+        }
+      }
+    }
+    break;
+  }
+
+  case ACCEPT:
+    if (item.i == length && finalStates[item.a]) {
+      callback(NONE, NONE);
+    }
+    for (const auto& transition : popTransitions) {
+      if (transition.from != item.a || transition.popSymbol != item.b || transition.firstSuffix == NONE) {
+        continue;
+      }
+      size_t next = advance(transition.inputSymbol, item.i, length);
+      if (next != NONE) {
+        callback(indexOf(make(ACCEPT_SUFFIX, transition.firstSuffix, transition.to, 0, next, 0)), NONE);
+      }
+    }
+    break;
+
+  case ACCEPT_SUFFIX: {
+    const Suffix& suffix = popSuffixes[item.a];
+    callback(indexOf(make(ACCEPT, item.b, suffix.symbol, 0, item.i, 0)), NONE);
+    if (suffix.next != NONE) {
+      for (size_t middle = 0; middle < stateCount; ++middle) {
+        for (size_t k = item.i; k <= length; ++k) {
+          callback(indexOf(make(POP, item.b, suffix.symbol, middle, item.i, k)),
+                   indexOf(make(ACCEPT_SUFFIX, suffix.next, middle, 0, k, 0)));
+        }
+      }
+    }
+    break;
+  }
+
+  case EMPTY:
+    if (item.i == length && (!useFinalStateAcceptance || finalStates[item.a])) {
+      callback(NONE, NONE);
+    }
+    for (const auto& transition : emptyTransitions) {
+      if (transition.from != item.a) {
+        continue;
+      }
+      size_t next = advance(transition.inputSymbol, item.i, length);
+      if (next == NONE) {
+        continue;
+      }
+      if (transition.firstSuffix == NONE) {
+        callback(indexOf(make(EMPTY, transition.to, 0, 0, next, 0)), NONE);
+      }
+      else {
+        callback(indexOf(make(EMPTY_SUFFIX, transition.firstSuffix, transition.to, 0, next, 0)), NONE);
+      }
+    }
+    break;
+
+  case EMPTY_SUFFIX: {
+    const Suffix& suffix = emptySuffixes[item.a];
+    if (useFinalStateAcceptance) {
+      callback(indexOf(make(ACCEPT, item.b, suffix.symbol, 0, item.i, 0)), NONE);
+    }
+    for (size_t middle = 0; middle < stateCount; ++middle) {
+      for (size_t k = item.i; k <= length; ++k) {
+        size_t popped = indexOf(make(POP, item.b, suffix.symbol, middle, item.i, k));
+        if (suffix.next == NONE) {
+          callback(popped, indexOf(make(EMPTY, middle, 0, 0, k, 0)));
+        }
+        else {
+          callback(popped, indexOf(make(EMPTY_SUFFIX, suffix.next, middle, 0, k, 0)));
+        }
+      }
+    }
+    break;
+  }
+  }
+}
+
+// Solves a group of items that may depend on each other (same span or same position) given
+// the values of all earlier groups:
+//  1. find which items are non-zero (boolean fixpoint),
+//  2. an item that is non-zero and depends on itself through non-zero terms has infinitely
+//     many computations, and so does every item depending on it,
+//  3. the remaining dependencies are acyclic, so plain iteration reaches the exact counts.
+void ComputationCounter::solveGroup(const std::vector<Item>& group) {
+  size_t size = group.size();
+  std::vector<size_t> indices(size);
+  std::unordered_map<size_t, size_t> local;
+  for (size_t k = 0; k < size; ++k) {
+    indices[k] = indexOf(group[k]);
+    local[indices[k]] = k;
+  }
+
+  // 1. Non-zero items
+  std::vector<bool> nonZero(size, false);
+  auto isNonZero = [&](size_t factor) {
+    if (factor == NONE) {
+      return true;
+    }
+    auto inGroup = local.find(factor);
+    return inGroup != local.end() ? static_cast<bool>(nonZero[inGroup->second]) : values[factor] != 0;
+  };
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t k = 0; k < size; ++k) {
+      if (nonZero[k]) {
+        continue;
+      }
+      bool found = false;
+      forEachTerm(group[k], [&](size_t first, size_t second) {
+        if (!found && isNonZero(first) && isNonZero(second)) {
+          found = true;
+        }
+      });
+      if (found) {
+        nonZero[k] = true;
+        changed = true;
+      }
+    }
+  }
+
+  // 2. Dependencies through non-zero terms, cycles and everything depending on them
+  std::vector<std::vector<size_t> > dependencies(size);
+  for (size_t k = 0; k < size; ++k) {
+    if (!nonZero[k]) {
+      continue;
+    }
+    forEachTerm(group[k], [&](size_t first, size_t second) {
+      if (!isNonZero(first) || !isNonZero(second)) {
+        return;
+      }
+      for (size_t factor : { first, second }) {
+        auto inGroup = factor == NONE ? local.end() : local.find(factor);
+        if (inGroup != local.end()) {
+          dependencies[k].push_back(inGroup->second);
+        }
+      }
+    });
+  }
+  std::vector<bool> infinite(size, false);
+  for (size_t k = 0; k < size; ++k) {
+    if (!nonZero[k]) {
+      continue;
+    }
+    // Is k reachable from itself?
+    std::vector<bool> visited(size, false);
+    std::vector<size_t> pending(dependencies[k]);
+    while (!pending.empty() && !infinite[k]) {
+      size_t current = pending.back();
+      pending.pop_back();
+      if (current == k) {
+        infinite[k] = true;
+      }
+      else if (!visited[current]) {
+        visited[current] = true;
+        pending.insert(pending.end(), dependencies[current].begin(), dependencies[current].end());
+      }
+    }
+  }
+  changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t k = 0; k < size; ++k) {
+      for (size_t dependency : dependencies[k]) {
+        if (infinite[dependency] && !infinite[k]) {
+          infinite[k] = true;
+          changed = true;
+        }
+      }
+    }
+  }
+
+  // 3. Exact (saturating) counts
+  for (size_t k = 0; k < size; ++k) {
+    values[indices[k]] = infinite[k] ? INFINITE : 0;
+  }
+  auto valueOf = [this](size_t factor) {
+    return factor == NONE ? static_cast<uint64_t>(1) : values[factor];
+  };
+  changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t k = 0; k < size; ++k) {
+      if (infinite[k] || !nonZero[k]) {
+        continue;
+      }
+      uint64_t total = 0;
+      forEachTerm(group[k], [&](size_t first, size_t second) {
+        total = add(total, multiply(valueOf(first), valueOf(second)));
+      });
+      if (total != values[indices[k]]) {
+        values[indices[k]] = total;
+        changed = true;
+      }
+    }
+  }
+}
+
+uint64_t ComputationCounter::count(const SymbolString& input) {
+  this->input = input;
+  size_t length = input.size();
+  span = length + 1;
+
+  size_t sizes[6];
+  sizes[POP] = stateCount * symbolCount * stateCount * span * span;
+  sizes[POP_SUFFIX] = popSuffixes.size() * stateCount * stateCount * span * span;
+  sizes[ACCEPT] = stateCount * symbolCount * span;
+  sizes[ACCEPT_SUFFIX] = popSuffixes.size() * stateCount * span;
+  sizes[EMPTY] = stateCount * span;
+  sizes[EMPTY_SUFFIX] = emptySuffixes.size() * stateCount * span;
+  size_t total = 0;
+  for (size_t kind = 0; kind < 6; ++kind) {
+    offsets[kind] = total;
+    total += sizes[kind];
+  }
+  values.assign(total, 0);
+
+  // Pop items by increasing span length: a span only depends on shorter spans and on itself
+  for (size_t width = 0; width <= length; ++width) {
+    for (size_t i = 0; i + width <= length; ++i) {
+      std::vector<Item> group;
+      for (size_t p = 0; p < stateCount; ++p) {
+        for (size_t q = 0; q < stateCount; ++q) {
+          for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+            Item item = { POP, p, symbol, q, i, i + width };
+            group.push_back(item);
+          }
+          for (size_t suffix = 0; suffix < popSuffixes.size(); ++suffix) {
+            Item item = { POP_SUFFIX, suffix, p, q, i, i + width };
+            group.push_back(item);
+          }
+        }
+      }
+      solveGroup(group);
+    }
+  }
+
+  // Acceptance items by decreasing position: they only depend on later positions and on themselves
+  for (size_t i = span; i > 0; --i) {
+    std::vector<Item> group;
+    for (size_t s = 0; s < stateCount; ++s) {
+      if (useFinalStateAcceptance) {
+        for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+          Item item = { ACCEPT, s, symbol, 0, i - 1, 0 };
+          group.push_back(item);
+        }
+        for (size_t suffix = 0; suffix < popSuffixes.size(); ++suffix) {
+          Item item = { ACCEPT_SUFFIX, suffix, s, 0, i - 1, 0 };
+          group.push_back(item);
+        }
+      }
+      Item empty = { EMPTY, s, 0, 0, i - 1, 0 };
+      group.push_back(empty);
+      for (size_t suffix = 0; suffix < emptySuffixes.size(); ++suffix) {
+        Item item = { EMPTY_SUFFIX, suffix, s, 0, i - 1, 0 };
+        group.push_back(item);
+      }
+    }
+    solveGroup(group);
+  }
+
+  // Computations still inside the region of the initial symbol, plus those that pop it at k
+  // and continue from an empty stack
+  uint64_t result = 0;
+  if (useFinalStateAcceptance) {
+    Item accept = { ACCEPT, initialState, initialSymbol, 0, 0, 0 };
+    result = values[indexOf(accept)];
+  }
+  for (size_t q = 0; q < stateCount; ++q) {
+    for (size_t k = 0; k <= length; ++k) {
+      Item popped = { POP, initialState, initialSymbol, q, 0, k };
+      Item empty = { EMPTY, q, 0, 0, k, 0 };
+      result = add(result, multiply(values[indexOf(popped)], values[indexOf(empty)]));
+    }
+  }
+  return result;
+}
@@ -0,0 +1,26 @@
+#include "../include/Configuration.h"
+
+Configuration::Configuration(const State& state, const Stack& stack)
+  : state(state),
+    stack(stack) {}
+
+// Getters
+const State& Configuration::getState() const {
+  return state;
+}
+
+const Stack& Configuration::getStack() const {
+  return stack;
+}
+
+// Operator overloading for comparison
+bool Configuration::operator<(const Configuration& other) const {
+  if (!(state == other.state)) {
+    return state < other.state;
+  }
+  return stack < other.stack;
+}
+
+bool Configuration::operator==(const Configuration& other) const {
+  return state == other.state && stack == other.stack;
+}
@@ -0,0 +1,248 @@
+#include "../include/CounterPDA.h"
+#include <map>
+#include <set>
+
+const size_t CounterPDA::MAX_COUNTERS;
+const int CounterPDA::BOTTOM;
+const int CounterPDA::NO_POP;
+const int CounterPDA::EMPTY;
+
+CounterPDA::CounterPDA()
+  : compiled(false),
+    useFinalStateAcceptance(true),
+    counterCount(0),
+    initialState(0) {}
+
+// The stack (bottom to top) must always read Z? S1^n1 S2^n2 ... Sk^nk for a fixed order of
+// the counter symbols S1 < S2 < ... < Sk. Every push is checked to keep that shape:
+//  - the bottom marker Z may only be pushed back as the deepest symbol right after popping it,
+//  - the pushed symbols must be non-decreasing from bottom to top,
+//  - the deepest pushed symbol must not be smaller than the symbol left below it.
+// These give "a <= b" constraints between symbols; the automaton qualifies if they admit an order.
+bool CounterPDA::compile(const PDA& pda) {
+  compiled = false;
+  Symbol bottom = pda.getInitialStackSymbol();
+
+  std::set<Symbol> counterSymbols;
+  for (const auto& transition : pda.getTransitions()) {
+    for (Symbol symbol : transition.getSymbolsToPush()) {
+      if (symbol != bottom) {
+        counterSymbols.insert(symbol);
+      }
+    }
+  }
+  if (counterSymbols.size() > MAX_COUNTERS) {
+    return false;
+  }
+
+  std::set<std::pair<Symbol, Symbol> > lessOrEqual; // (a, b): a must be below b
+  for (const auto& transition : pda.getTransitions()) {
+    Symbol popped = transition.getStackSymbol();
+    SymbolString pushed = transition.getSymbolsToPush();
+
+    if (!pushed.empty() && pushed[pushed.size() - 1] == bottom) {
+      if (popped != bottom) {
+        return false;
+      }
+      pushed.erase(pushed.size() - 1);
+    }
+    if (pushed.find(bottom) != SymbolString::npos) {
+      return false;
+    }
+    if (pushed.empty()) {
+      continue;
+    }
+
+    // pushed[0] ends on top, so each symbol must not be smaller than the one after it
+    for (size_t i = 0; i + 1 < pushed.size(); ++i) {
+      if (pushed[i] != pushed[i + 1]) {
+        lessOrEqual.insert(std::make_pair(pushed[i + 1], pushed[i]));
+      }
+    }
+    Symbol deepest = pushed[pushed.size() - 1];
+    if (popped == '\0') {
+      // Anything may be below a stack-epsilon push
+      for (Symbol symbol : counterSymbols) {
+        if (symbol != deepest) {
+          lessOrEqual.insert(std::make_pair(symbol, deepest));
+        }
+      }
+    }
+    else if (popped != bottom && counterSymbols.count(popped) && popped != deepest) {
+      lessOrEqual.insert(std::make_pair(popped, deepest));
+    }
+  }
+
+  // Topological sort of the counter symbols; a cycle means the blocks can interleave
+  std::map<Symbol, int> counterIndex;
+  std::set<Symbol> remaining(counterSymbols);
+  while (!remaining.empty()) {
+    Symbol next = '\0';
+    bool found = false;
+    for (Symbol candidate : remaining) {
+      bool hasSmaller = false;
+      for (const auto& constraint : lessOrEqual) {
+        if (constraint.second == candidate && remaining.count(constraint.first)) {
+          hasSmaller = true;
+          break;
+        }
+      }
+      if (!hasSmaller) {
+        next = candidate;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+    int index = static_cast<int>(counterIndex.size());
+    counterIndex[next] = index;
+    remaining.erase(next);
+  }
+  counterCount = counterIndex.size();
+
+  // Dense state numbering
+  std::map<State, uint32_t> stateIndex;
+  for (const auto& state : pda.getStates()) {
+    uint32_t index = static_cast<uint32_t>(stateIndex.size());
+    stateIndex[state] = index;
+  }
+  initialState = stateIndex[pda.getInitialState()];
+  finalStates.assign(stateIndex.size(), false);
+  for (const auto& state : pda.getFinalStates()) {
+    finalStates[stateIndex[state]] = true;
+  }
+  useFinalStateAcceptance = pda.getUseFinalStateAcceptance();
+
+  // Buckets follow the PDA's dispatch order, so a profile applied with reorderTransitions
+  // before compiling carries over
+  transitionsByState.assign(stateIndex.size(), std::vector<CounterTransition>());
+  for (const auto& source : stateIndex) {
+    for (size_t transitionIndex : pda.getDispatchOrder(source.first)) {
+      const Transition& transition = pda.getTransitions()[transitionIndex];
+      CounterTransition compiledTransition;
+      compiledTransition.nextState = stateIndex[transition.getNextState()];
+      compiledTransition.inputSymbol = transition.getInputSymbol();
+      Symbol popped = transition.getStackSymbol();
+      if (popped == '\0') {
+        compiledTransition.popSymbol = NO_POP;
+      }
+      else if (popped == bottom) {
+        compiledTransition.popSymbol = BOTTOM;
+      }
+      else if (counterIndex.count(popped)) {
+        compiledTransition.popSymbol = counterIndex[popped];
+      }
+      else {
+        continue; // Pops a symbol that is never pushed: it can never fire
+      }
+      for (size_t i = 0; i < MAX_COUNTERS; ++i) {
+        compiledTransition.pushes[i] = 0;
+      }
+      compiledTransition.pushesBottom = false;
+      for (Symbol symbol : transition.getSymbolsToPush()) {
+        if (symbol == bottom) {
+          compiledTransition.pushesBottom = true;
+        }
+        else {
+          compiledTransition.pushes[counterIndex[symbol]]++;
+        }
+      }
+      transitionsByState[source.second].push_back(compiledTransition);
+    }
+  }
+
+  compiled = true;
+  return true;
+}
+
+bool CounterPDA::isCompiled() const {
+  return compiled;
+}
+
+size_t CounterPDA::getCounterCount() const {
+  return counterCount;
+}
+
+bool CounterPDA::processInput(const SymbolString& input) const {
+  Configuration initial;
+  initial.state = initialState;
+  initial.hasBottom = 1;
+  for (size_t i = 0; i < MAX_COUNTERS; ++i) {
+    initial.counts[i] = 0;
+  }
+  return search(input, initial);
+}
+
+// Top of the stack: the highest non-empty block, then the bottom marker
+int CounterPDA::top(const Configuration& configuration) const {
+  for (size_t i = counterCount; i > 0; --i) {
+    if (configuration.counts[i - 1] > 0) {
+      return static_cast<int>(i - 1);
+    }
+  }
+  return configuration.hasBottom ? BOTTOM : EMPTY;
+}
+
+bool CounterPDA::apply(const CounterTransition& transition, Configuration& configuration) const {
+  if (transition.popSymbol != NO_POP) {
+    if (top(configuration) != transition.popSymbol) {
+      return false;
+    }
+    if (transition.popSymbol == BOTTOM) {
+      configuration.hasBottom = 0;
+    }
+    else {
+      configuration.counts[transition.popSymbol]--;
+    }
+  }
+  for (size_t i = 0; i < counterCount; ++i) {
+    configuration.counts[i] += transition.pushes[i];
+  }
+  if (transition.pushesBottom) {
+    configuration.hasBottom = 1;
+  }
+  configuration.state = transition.nextState;
+  return true;
+}
+
+// Same depth-first search as PDA::processRecursive over the compact configurations, in the
+// same order, but over an explicit stack of frames: the depth grows with the input, and a long
+// input would otherwise overflow the call stack.
+bool CounterPDA::search(const SymbolString& input, const Configuration& initial) const {
+  std::vector<Frame> frames;
+  Frame first = {initial, 0, 0};
+  frames.push_back(first);
+
+  while (!frames.empty()) {
+    Frame& frame = frames.back();
+    if (frame.nextTransition == 0 && frame.position == input.size() &&
+        (useFinalStateAcceptance ? finalStates[frame.configuration.state]
+                                 : (!frame.configuration.hasBottom && top(frame.configuration) == EMPTY))) {
+      return true;
+    }
+
+    const std::vector<CounterTransition>& bucket = transitionsByState[frame.configuration.state];
+    bool advanced = false;
+    while (frame.nextTransition < bucket.size() && !advanced) {
+      const CounterTransition& transition = bucket[frame.nextTransition++];
+      size_t nextPosition = frame.position;
+      if (transition.inputSymbol != '\0') {
+        if (nextPosition >= input.size() || input[nextPosition] != transition.inputSymbol) {
+          continue;
+        }
+        nextPosition++;
+      }
+      Frame next = {frame.configuration, nextPosition, 0};
+      if (apply(transition, next.configuration)) {
+        frames.push_back(next); // frame is not used past this point
+        advanced = true;
+      }
+    }
+    if (!advanced) {
+      frames.pop_back(); // Backtrack
+    }
+  }
+  return false;
+}
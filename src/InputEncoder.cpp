@@ -0,0 +1,231 @@
+#include "../include/InputEncoder.h"
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#if defined(__SSE2__) && PDA_SYMBOL_BITS == 8
+#include <emmintrin.h>
+#endif
+
+// Largest alphabet handled by the vector kernel; each symbol costs a compare per 16 bytes
+static const size_t MAX_SIMD_SYMBOLS = 16;
+
+InputEncoder::InputEncoder(const PDA& pda) {
+  std::fill(lookup, lookup + 256, 0);
+
+  // Only symbols that some transition reads can appear in an accepted input
+  std::set<Symbol> readSymbols;
+  for (const auto& transition : pda.getTransitions()) {
+    if (transition.getInputSymbol() != '\0') {
+      readSymbols.insert(transition.getInputSymbol());
+    }
+  }
+  for (Symbol symbol : pda.getInputAlphabet()) {
+    declaredSymbols += symbol;
+    if (readSymbols.count(symbol)) {
+      alphabet.push_back(symbol);
+      uint32_t value = symbolValue(symbol);
+      if (value < 256) {
+        lookup[value] = static_cast<uint32_t>(alphabet.size());
+      }
+      else {
+        wideLookup[symbol] = static_cast<uint32_t>(alphabet.size());
+      }
+    }
+  }
+}
+
+size_t InputEncoder::code(Symbol symbol) const {
+  uint32_t value = symbolValue(symbol);
+  if (value < 256) {
+    return lookup[value];
+  }
+  auto entry = wideLookup.find(symbol);
+  return entry == wideLookup.end() ? 0 : entry->second;
+}
+
+// Counts are only complete when the input is valid. The vector kernel compares 16 symbols at a
+// time, so it is only compiled into 8-bit builds.
+bool InputEncoder::scan(const SymbolString& input, std::vector<size_t>& counts, size_t& firstInvalid) const {
+  counts.assign(alphabet.size(), 0);
+  size_t length = input.size();
+  size_t position = 0;
+
+#if defined(__SSE2__) && PDA_SYMBOL_BITS == 8
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(input.data());
+  if (alphabet.size() <= MAX_SIMD_SYMBOLS) {
+    size_t symbolCount = alphabet.size();
+    const __m128i zero = _mm_setzero_si128();
+    __m128i patterns[MAX_SIMD_SYMBOLS];
+    __m128i tallies[MAX_SIMD_SYMBOLS]; // Per-byte-lane counters, flushed before they can overflow
+    for (size_t i = 0; i < symbolCount; ++i) {
+      patterns[i] = _mm_set1_epi8(alphabet[i]);
+      tallies[i] = zero;
+    }
+
+    auto flushTallies = [&]() {
+      for (size_t i = 0; i < symbolCount; ++i) {
+        __m128i sums = _mm_sad_epu8(tallies[i], zero);
+        counts[i] += static_cast<size_t>(_mm_cvtsi128_si32(sums)) +
+                     static_cast<size_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+        tallies[i] = zero;
+      }
+    };
+
+    size_t chunksInTallies = 0;
+    while (position + 16 <= length) {
+      __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+      __m128i valid = zero;
+      for (size_t i = 0; i < symbolCount; ++i) {
+        __m128i matches = _mm_cmpeq_epi8(chunk, patterns[i]);
+        valid = _mm_or_si128(valid, matches);
+        tallies[i] = _mm_sub_epi8(tallies[i], matches); // Matching lanes are -1
+      }
+
+      int invalidLanes = ~_mm_movemask_epi8(valid) & 0xFFFF;
+      if (invalidLanes != 0) {
+        firstInvalid = position + static_cast<size_t>(__builtin_ctz(invalidLanes));
+        flushTallies();
+        return false;
+      }
+
+      position += 16;
+      if (++chunksInTallies == 255) {
+        flushTallies();
+        chunksInTallies = 0;
+      }
+    }
+    flushTallies();
+  }
+#endif
+
+  // Scalar tail, and whole input for large alphabets or targets without SSE2
+  for (; position < length; ++position) {
+    size_t index = code(input[position]);
+    if (index == 0) {
+      firstInvalid = position;
+      return false;
+    }
+    counts[index - 1]++;
+  }
+  return true;
+}
+
+// The relation is searched outside <NNN> groups, so '<48>=<49>' compares two symbols
+bool InputEncoder::addConstraint(const std::string& constraint) {
+  static const char* relations[] = { "<=", ">=", "!=", "=", "<", ">" };
+  size_t position = 0;
+  std::string relation;
+  while (position < constraint.size() && relation.empty()) {
+    size_t next = position;
+    Symbol symbol;
+    if (constraint[position] == '<' && parseSymbol(constraint.data(), constraint.size(), next, symbol) &&
+        next > position + 1) {
+      position = next;
+      continue;
+    }
+    for (const char* candidate : relations) {
+      if (constraint.compare(position, std::string(candidate).size(), candidate) == 0) {
+        relation = candidate;
+        break;
+      }
+    }
+    if (relation.empty()) {
+      position++;
+    }
+  }
+
+  Constraint parsed;
+  parsed.relation = relation;
+  if (!relation.empty() && parseOperand(constraint.substr(0, position), parsed.left) &&
+      parseOperand(constraint.substr(position + relation.size()), parsed.right)) {
+    constraints.push_back(parsed);
+    return true;
+  }
+  std::cerr << "Error: Invalid Parikh constraint '" << constraint
+            << "'. Expected <operand><relation><operand> with relation =, !=, <, <=, > or >=, where an operand is"
+            << " an input symbol (a or <NNN>) or a count (N, or #N if digits are input symbols)." << std::endl;
+  return false;
+}
+
+// Input symbols take precedence over numbers: with digits in the alphabet, "0" is the symbol and
+// a count must be written #N. A number made of alphabet digits is ambiguous and refused.
+bool InputEncoder::parseOperand(const std::string& text, Operand& operand) const {
+  if (text.empty()) {
+    return false;
+  }
+  bool explicitCount = text[0] == '#';
+  std::string digits = explicitCount ? text.substr(1) : text;
+  if (!digits.empty() && digits.find_first_not_of("0123456789") == std::string::npos) {
+    if (!explicitCount && digits.size() == 1 && declaredSymbols.find(static_cast<Symbol>(digits[0])) != SymbolString::npos) {
+      return parseSymbolOperand(text, operand);
+    }
+    bool usesSymbols = false;
+    for (char digit : digits) {
+      usesSymbols = usesSymbols || declaredSymbols.find(static_cast<Symbol>(digit)) != SymbolString::npos;
+    }
+    if (!explicitCount && usesSymbols) {
+      std::cerr << "Error: Ambiguous Parikh operand '" << text << "': its digits are input symbols. Write #" << text
+                << " for the count." << std::endl;
+      return false;
+    }
+    operand.isSymbol = false;
+    operand.value = static_cast<size_t>(std::strtoull(digits.c_str(), nullptr, 10));
+    return true;
+  }
+  return !explicitCount && parseSymbolOperand(text, operand);
+}
+
+bool InputEncoder::parseSymbolOperand(const std::string& text, Operand& operand) const {
+  size_t position = 0;
+  Symbol symbol;
+  if (!parseSymbol(text.data(), text.size(), position, symbol) || position != text.size() || declaredSymbols.find(symbol) == SymbolString::npos) {
+    return false;
+  }
+  size_t index = code(symbol);
+  if (index == 0) {
+    // Symbols that no transition reads never occur in an input that passed validation
+    operand.isSymbol = false;
+    operand.value = 0;
+  }
+  else {
+    operand.isSymbol = true;
+    operand.value = index - 1;
+  }
+  return true;
+}
+
+bool InputEncoder::satisfies(const Constraint& constraint, const std::vector<size_t>& counts) const {
+  size_t left = constraint.left.isSymbol ? counts[constraint.left.value] : constraint.left.value;
+  size_t right = constraint.right.isSymbol ? counts[constraint.right.value] : constraint.right.value;
+  const std::string& relation = constraint.relation;
+  if (relation == "=") {
+    return left == right;
+  }
+  if (relation == "!=") {
+    return left != right;
+  }
+  if (relation == "<") {
+    return left < right;
+  }
+  if (relation == "<=") {
+    return left <= right;
+  }
+  if (relation == ">") {
+    return left > right;
+  }
+  return left >= right;
+}
+
+bool InputEncoder::mayAccept(const SymbolString& input) const {
+  std::vector<size_t> counts;
+  size_t firstInvalid = 0;
+  if (!scan(input, counts, firstInvalid)) {
+    return false;
+  }
+  for (const auto& constraint : constraints) {
+    if (!satisfies(constraint, counts)) {
+      return false;
+    }
+  }
+  return true;
+}
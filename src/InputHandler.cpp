@@ -5,183 +5,280 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <unordered_set>
+#include <cstring>
+#include <cctype>
 
-bool InputHandler::loadAutomatonDefinition(PDA& pda, const std::string& filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    std::cerr << "Error: No se pudo abrir el archivo de definición del autómata: " << filename << std::endl;
+// The definition is read into memory once and tokenized in place. Names and symbols are
+// validated against lookup tables built while the header lines are read (hash sets of state
+// names and of the symbols of each alphabet), so loading is linear in the size of the file.
+// Symbols are single bytes or, for values no byte can express, the numeric notation <NNN>.
+
+// Cursor over the significant lines of the buffer: comment and blank lines are skipped and
+// carriage returns are treated as whitespace
+struct DefinitionReader {
+  const char* current;
+  const char* end;
+  const char* lineBegin;
+  const char* lineEnd;
+  int lineNumber;
+};
+
+static bool isBlank(char c) {
+  return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+static bool nextLine(DefinitionReader& reader) {
+  while (reader.current < reader.end) {
+    const char* newline = static_cast<const char*>(std::memchr(reader.current, '\n', reader.end - reader.current));
+    const char* begin = reader.current;
+    const char* end = newline ? newline : reader.end;
+    reader.current = newline ? newline + 1 : reader.end;
+    reader.lineNumber++;
+    while (begin < end && isBlank(*begin)) {
+      ++begin;
+    }
+    while (end > begin && isBlank(end[-1])) {
+      --end;
+    }
+    if (begin == end || *begin == '#') {
+      continue;
+    }
+    reader.lineBegin = begin;
+    reader.lineEnd = end;
+    return true;
+  }
+  return false;
+}
+
+// Next whitespace-separated token of the current line; false when the line is exhausted
+static bool nextToken(DefinitionReader& reader, const char*& tokenBegin, size_t& tokenLength) {
+  while (reader.lineBegin < reader.lineEnd && isBlank(*reader.lineBegin)) {
+    ++reader.lineBegin;
+  }
+  if (reader.lineBegin == reader.lineEnd) {
     return false;
   }
+  tokenBegin = reader.lineBegin;
+  while (reader.lineBegin < reader.lineEnd && !isBlank(*reader.lineBegin)) {
+    ++reader.lineBegin;
+  }
+  tokenLength = reader.lineBegin - tokenBegin;
+  return true;
+}
 
-  std::string line;
-  int lineNumber = 0;
+static bool readSymbol(const char* text, size_t length, size_t& position, Symbol& symbol, int lineNumber) {
+  size_t start = position;
+  if (!parseSymbol(text, length, position, symbol)) {
+    std::cerr << "Error: El símbolo '" << std::string(text + start, position - start) << "' está fuera de rango (1 a "
+              << MAX_SYMBOL_VALUE << ") en la línea " << lineNumber << "." << std::endl;
+    return false;
+  }
+  return true;
+}
 
-  // Lambda function to skip comments and empty lines
-  auto skipCommentsAndEmptyLines = [&]() {
-    while (std::getline(file, line)) {
-      lineNumber++;
-      // Remove carriage returns and whitespace from both ends
-      line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-      line.erase(0, line.find_first_not_of(" \t")); // Trim leading whitespace
-      line.erase(line.find_last_not_of(" \t") + 1); // Trim trailing whitespace
-      if (line.empty() || line[0] == '#') {
-        continue;
-      }
-      else {
-        break;
-      }
+// Every non-whitespace character (or <NNN> group) of the current line is a symbol
+static bool readSymbols(DefinitionReader& reader, std::unordered_set<Symbol>& table, void (PDA::*add)(Symbol),
+                        PDA& pda) {
+  size_t length = reader.lineEnd - reader.lineBegin;
+  size_t position = 0;
+  while (position < length) {
+    if (isBlank(reader.lineBegin[position])) {
+      position++;
+      continue;
     }
-    };
+    Symbol symbol;
+    if (!readSymbol(reader.lineBegin, length, position, symbol, reader.lineNumber)) {
+      return false;
+    }
+    table.insert(symbol);
+    (pda.*add)(symbol);
+  }
+  return true;
+}
 
-  std::istringstream ss;
-  std::string stateName;
-  char symbol;
+// A transition field holding a single symbol, '.' for epsilon
+static bool fieldSymbol(const char* token, size_t length, Symbol& symbol, int lineNumber) {
+  if (length == 1 && token[0] == '.') {
+    symbol = '\0';
+    return true;
+  }
+  size_t position = 0;
+  return readSymbol(token, length, position, symbol, lineNumber);
+}
+
+// The current line without surrounding whitespace and with carriage returns removed
+static std::string currentLine(const char* begin, const char* end) {
+  std::string line(begin, end);
+  line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+  return line;
+}
+
+bool InputHandler::loadAutomatonDefinition(PDA& pda, const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Error: No se pudo abrir el archivo de definición del autómata: " << filename << std::endl;
+    return false;
+  }
+  // Read through the stream buffer rather than by size: pipes and other unseekable files have none
+  std::ostringstream contents;
+  if (file.peek() != std::ifstream::traits_type::eof()) {
+    contents << file.rdbuf();
+  }
+  if (file.bad()) {
+    std::cerr << "Error: No se pudo leer el archivo de definición del autómata: " << filename << std::endl;
+    return false;
+  }
+  file.close();
+  std::string buffer = contents.str();
+
+  DefinitionReader reader = { buffer.data(), buffer.data() + buffer.size(), nullptr, nullptr, 0 };
+  std::unordered_set<std::string> stateNames;
+  std::unordered_set<Symbol> inputSymbols;
+  std::unordered_set<Symbol> stackSymbols;
+  const char* token;
+  size_t length;
 
   // Load States
-  skipCommentsAndEmptyLines();
-  if (file.eof()) {
-    std::cerr << "Error: Se esperaba una lista de estados en la línea " << lineNumber << "." << std::endl;
+  if (!nextLine(reader)) {
+    std::cerr << "Error: Se esperaba una lista de estados en la línea " << reader.lineNumber << "." << std::endl;
     return false;
   }
-  ss.clear();
-  ss.str(line);
-  while (ss >> stateName) {
-    pda.addState(stateName);
+  while (nextToken(reader, token, length)) {
+    std::string stateName(token, length);
+    if (stateNames.insert(stateName).second) {
+      pda.addState(stateName);
+    }
   }
-  if (pda.getStates().empty()) {
+  if (stateNames.empty()) {
     std::cerr << "Error: No se definieron estados en el autómata." << std::endl;
     return false;
   }
 
   // Load Input Alphabet
-  skipCommentsAndEmptyLines();
-  if (file.eof()) {
-    std::cerr << "Error: Se esperaba un alfabeto de entrada en la línea " << lineNumber << "." << std::endl;
+  if (!nextLine(reader)) {
+    std::cerr << "Error: Se esperaba un alfabeto de entrada en la línea " << reader.lineNumber << "." << std::endl;
     return false;
   }
-  ss.clear();
-  ss.str(line);
-  while (ss >> symbol) {
-    pda.addInputSymbol(symbol);
+  if (!readSymbols(reader, inputSymbols, &PDA::addInputSymbol, pda)) {
+    return false;
   }
 
   // Load Stack Alphabet
-  skipCommentsAndEmptyLines();
-  if (file.eof()) {
-    std::cerr << "Error: Se esperaba un alfabeto de pila en la línea " << lineNumber << "." << std::endl;
+  if (!nextLine(reader)) {
+    std::cerr << "Error: Se esperaba un alfabeto de pila en la línea " << reader.lineNumber << "." << std::endl;
     return false;
   }
-  ss.clear();
-  ss.str(line);
-  while (ss >> symbol) {
-    pda.addStackSymbol(symbol);
+  if (!readSymbols(reader, stackSymbols, &PDA::addStackSymbol, pda)) {
+    return false;
   }
 
   // Load Initial State
-  skipCommentsAndEmptyLines();
-  if (file.eof()) {
-    std::cerr << "Error: Se esperaba un estado inicial en la línea " << lineNumber << "." << std::endl;
+  if (!nextLine(reader)) {
+    std::cerr << "Error: Se esperaba un estado inicial en la línea " << reader.lineNumber << "." << std::endl;
     return false;
   }
-  ss.clear();
-  ss.str(line);
-  ss >> stateName;
-  if (!pda.getStates().count(State(stateName))) {
-    std::cerr << "Error: El estado inicial '" << stateName << "' no está definido en los estados del autómata." << std::endl;
+  nextToken(reader, token, length);
+  std::string initialState(token, length);
+  if (!stateNames.count(initialState)) {
+    std::cerr << "Error: El estado inicial '" << initialState << "' no está definido en los estados del autómata." << std::endl;
     return false;
   }
-  pda.setInitialState(stateName);
+  pda.setInitialState(initialState);
 
   // Load Initial Stack Symbol
-  skipCommentsAndEmptyLines();
-  if (file.eof()) {
-    std::cerr << "Error: Se esperaba un símbolo inicial de pila en la línea " << lineNumber << "." << std::endl;
+  if (!nextLine(reader)) {
+    std::cerr << "Error: Se esperaba un símbolo inicial de pila en la línea " << reader.lineNumber << "." << std::endl;
     return false;
   }
-  ss.clear();
-  ss.str(line);
-  ss >> symbol;
-  if (!pda.getStackAlphabet().count(symbol)) {
-    std::cerr << "Error: El símbolo inicial de pila '" << symbol << "' no está definido en el alfabeto de pila." << std::endl;
+  nextToken(reader, token, length);
+  Symbol initialStackSymbol;
+  if (!fieldSymbol(token, length, initialStackSymbol, reader.lineNumber)) {
     return false;
   }
-  pda.setInitialStackSymbol(symbol);
+  if (!stackSymbols.count(initialStackSymbol)) {
+    std::cerr << "Error: El símbolo inicial de pila '" << symbolToText(initialStackSymbol) << "' no está definido en el alfabeto de pila." << std::endl;
+    return false;
+  }
+  pda.setInitialStackSymbol(initialStackSymbol);
 
   // Load Final States (if APf)
   if (pda.getUseFinalStateAcceptance()) {
-    skipCommentsAndEmptyLines();
-    if (file.eof()) {
-      std::cerr << "Error: Se esperaba una lista de estados finales en la línea " << lineNumber << "." << std::endl;
+    if (!nextLine(reader)) {
+      std::cerr << "Error: Se esperaba una lista de estados finales en la línea " << reader.lineNumber << "." << std::endl;
       return false;
     }
-    ss.clear();
-    ss.str(line);
-    bool hasFinalState = false;
-    while (ss >> stateName) {
-      if (!pda.getStates().count(State(stateName))) {
+    while (nextToken(reader, token, length)) {
+      std::string stateName(token, length);
+      if (!stateNames.count(stateName)) {
         std::cerr << "Error: El estado final '" << stateName << "' no está definido en los estados del autómata." << std::endl;
         return false;
       }
       pda.addFinalState(stateName);
-      hasFinalState = true;
     }
-    if (!hasFinalState) {
+    if (pda.getFinalStates().empty()) {
       std::cerr << "Error: No se definieron estados finales en el autómata." << std::endl;
       return false;
     }
   }
 
   // Load Transitions
-  while (std::getline(file, line)) {
-    lineNumber++;
-    line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-    line.erase(0, line.find_first_not_of(" \t")); // Trim leading whitespace
-    line.erase(line.find_last_not_of(" \t") + 1); // Trim trailing whitespace
-    if (line.empty() || line[0] == '#') {
-      continue;
-    }
-    ss.clear();
-    ss.str(line);
-    std::string currentState, inputSymStr, stackSymStr, nextState, symbolsToPush;
-    if (!(ss >> currentState >> inputSymStr >> stackSymStr >> nextState >> symbolsToPush)) {
-      std::cerr << "Error: Formato incorrecto en la línea " << lineNumber << ": '" << line << "'" << std::endl;
-      return false;
+  std::string currentState, nextState;
+  SymbolString symbolsToPush;
+  while (nextLine(reader)) {
+    const char* lineBegin = reader.lineBegin;
+    const char* tokens[5];
+    size_t lengths[5];
+    for (int i = 0; i < 5; ++i) {
+      if (!nextToken(reader, tokens[i], lengths[i])) {
+        std::cerr << "Error: Formato incorrecto en la línea " << reader.lineNumber << ": '" << currentLine(lineBegin, reader.lineEnd) << "'" << std::endl;
+        return false;
+      }
     }
 
     // Validate currentState and nextState
-    if (!pda.getStates().count(State(currentState))) {
-      std::cerr << "Error: El estado actual '" << currentState << "' no está definido en los estados del autómata (línea " << lineNumber << ")." << std::endl;
+    currentState.assign(tokens[0], lengths[0]);
+    nextState.assign(tokens[3], lengths[3]);
+    if (!stateNames.count(currentState)) {
+      std::cerr << "Error: El estado actual '" << currentState << "' no está definido en los estados del autómata (línea " << reader.lineNumber << ")." << std::endl;
       return false;
     }
-    if (!pda.getStates().count(State(nextState))) {
-      std::cerr << "Error: El estado siguiente '" << nextState << "' no está definido en los estados del autómata (línea " << lineNumber << ")." << std::endl;
+    if (!stateNames.count(nextState)) {
+      std::cerr << "Error: El estado siguiente '" << nextState << "' no está definido en los estados del autómata (línea " << reader.lineNumber << ")." << std::endl;
       return false;
     }
 
     // Handle epsilon represented as '.'
-    char inputSym = inputSymStr == "." ? '\0' : inputSymStr[0];
-    char stackSym = stackSymStr == "." ? '\0' : stackSymStr[0];
+    Symbol inputSym;
+    Symbol stackSym;
+    if (!fieldSymbol(tokens[1], lengths[1], inputSym, reader.lineNumber) ||
+        !fieldSymbol(tokens[2], lengths[2], stackSym, reader.lineNumber)) {
+      return false;
+    }
 
     // Validate input symbol if not epsilon
-    if (inputSym != '\0' && !pda.getInputAlphabet().count(inputSym)) {
-      std::cerr << "Error: El símbolo de entrada '" << inputSym << "' no está en el alfabeto de entrada (línea " << lineNumber << ")." << std::endl;
+    if (inputSym != '\0' && !inputSymbols.count(inputSym)) {
+      std::cerr << "Error: El símbolo de entrada '" << symbolToText(inputSym) << "' no está en el alfabeto de entrada (línea " << reader.lineNumber << ")." << std::endl;
       return false;
     }
 
     // Validate stack symbol if not epsilon
-    if (stackSym != '\0' && !pda.getStackAlphabet().count(stackSym)) {
-      std::cerr << "Error: El símbolo de pila '" << stackSym << "' no está en el alfabeto de pila (línea " << lineNumber << ")." << std::endl;
+    if (stackSym != '\0' && !stackSymbols.count(stackSym)) {
+      std::cerr << "Error: El símbolo de pila '" << symbolToText(stackSym) << "' no está en el alfabeto de pila (línea " << reader.lineNumber << ")." << std::endl;
       return false;
     }
 
     // Validate symbols to push
-    if (symbolsToPush == ".") {
-      symbolsToPush = "";
-    }
-    else {
-      for (char c : symbolsToPush) {
-        if (!pda.getStackAlphabet().count(c)) {
-          std::cerr << "Error: El símbolo a apilar '" << c << "' no está en el alfabeto de pila (línea " << lineNumber << ")." << std::endl;
+    symbolsToPush.clear();
+    if (lengths[4] != 1 || tokens[4][0] != '.') {
+      for (size_t position = 0; position < lengths[4];) {
+        Symbol c;
+        if (!readSymbol(tokens[4], lengths[4], position, c, reader.lineNumber)) {
+          return false;
+        }
+        symbolsToPush += c;
+        if (!stackSymbols.count(c)) {
+          std::cerr << "Error: El símbolo a apilar '" << symbolToText(c) << "' no está en el alfabeto de pila (línea " << reader.lineNumber << ")." << std::endl;
           return false;
         }
       }
@@ -190,13 +287,12 @@ bool InputHandler::loadAutomatonDefinition(PDA& pda, const std::string& filename
     pda.addTransition(currentState, inputSym, stackSym, nextState, symbolsToPush);
   }
 
-  file.close();
   return true;
 }
 
 
-std::vector<std::string> InputHandler::loadInputStrings(const std::string& filename) {
-  std::vector<std::string> inputStrings;
+std::vector<SymbolString> InputHandler::loadInputStrings(const std::string& filename) {
+  std::vector<SymbolString> inputStrings;
   std::ifstream file(filename);
   if (!file.is_open()) {
     std::cerr << "Error opening input strings file: " << filename << std::endl;
@@ -208,7 +304,7 @@ std::vector<std::string> InputHandler::loadInputStrings(const std::string& filen
     // Remove whitespace and comments
     line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
     if (!line.empty() && line[0] != '#') {
-      inputStrings.push_back(line);
+      inputStrings.push_back(textToSymbols(line));
     }
   }
 
@@ -216,6 +312,53 @@ std::vector<std::string> InputHandler::loadInputStrings(const std::string& filen
   return inputStrings;
 }
 
+// Lexer output is fed in without re-encoding: each token id is used as the symbol value, so the
+// ids must match the <NNN> symbols of the definition. Blank lines and '#' comments are skipped.
+bool InputHandler::loadTokenStrings(const std::string& filename, std::vector<SymbolString>& inputStrings) {
+  inputStrings.clear();
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error opening input strings file: " << filename << std::endl;
+    return false;
+  }
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    size_t position = line.find_first_not_of(" \t\r");
+    if (position == std::string::npos || line[position] == '#') {
+      continue;
+    }
+    SymbolString tokens;
+    while (position < line.size()) {
+      if (isBlank(line[position])) {
+        position++;
+        continue;
+      }
+      uint64_t value = 0;
+      size_t start = position;
+      while (position < line.size() && line[position] >= '0' && line[position] <= '9' &&
+             value <= MAX_SYMBOL_VALUE) {
+        value = value * 10 + static_cast<uint64_t>(line[position] - '0');
+        position++;
+      }
+      if (position == start || value == 0 || value > MAX_SYMBOL_VALUE ||
+          (position < line.size() && !isBlank(line[position]))) {
+        std::cerr << "Error: Invalid token in line " << lineNumber << " of " << filename
+                  << ". Tokens must be integers from 1 to " << MAX_SYMBOL_VALUE << "." << std::endl;
+        inputStrings.clear();
+        return false;
+      }
+      tokens += static_cast<Symbol>(value);
+    }
+    inputStrings.push_back(tokens);
+  }
+
+  file.close();
+  return true;
+}
+
 void InputHandler::writeTraceOutput(const std::string& trace, const std::string& filename) {
   std::ofstream file(filename);
   if (file.is_open()) {
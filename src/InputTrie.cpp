@@ -0,0 +1,38 @@
+#include "../include/InputTrie.h"
+
+const size_t InputTrie::ROOT;
+
+InputTrie::InputTrie() {
+  nodes.push_back(Node());
+  nodes[ROOT].terminal = false;
+}
+
+size_t InputTrie::insert(const SymbolString& input) {
+  size_t node = ROOT;
+  for (Symbol symbol : input) {
+    auto child = nodes[node].children.find(symbol);
+    if (child != nodes[node].children.end()) {
+      node = child->second;
+      continue;
+    }
+    size_t newNode = nodes.size();
+    nodes[node].children[symbol] = newNode;
+    nodes.push_back(Node());
+    nodes[newNode].terminal = false;
+    node = newNode;
+  }
+  nodes[node].terminal = true;
+  return node;
+}
+
+size_t InputTrie::getNodeCount() const {
+  return nodes.size();
+}
+
+const std::map<Symbol, size_t>& InputTrie::getChildren(size_t node) const {
+  return nodes[node].children;
+}
+
+bool InputTrie::isTerminal(size_t node) const {
+  return nodes[node].terminal;
+}
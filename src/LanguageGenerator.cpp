@@ -0,0 +1,226 @@
+#include "../include/LanguageGenerator.h"
+#include "../include/AutomatonAnalyzer.h"
+#include <random>
+#include <limits>
+
+const uint64_t LanguageGenerator::SATURATED = std::numeric_limits<uint64_t>::max();
+const size_t LanguageGenerator::DEAD = static_cast<size_t>(-1);
+const size_t LanguageGenerator::BUFFER_LIMIT;
+
+static uint64_t saturatingAdd(uint64_t a, uint64_t b) {
+  return a > LanguageGenerator::SATURATED - b ? LanguageGenerator::SATURATED : a + b;
+}
+
+LanguageGenerator::LanguageGenerator(const PDA& pda, size_t maxLength, size_t maxStackHeight)
+  : pda(pda),
+    maxLength(maxLength),
+    completion(pda, maxLength),
+    maxStackHeight(AutomatonAnalyzer::closureStackBound(pda, maxStackHeight)),
+    truncated(false),
+    symbols(pda.getInputAlphabet().begin(), pda.getInputAlphabet().end()) {
+  std::set<Configuration> initial;
+  initial.insert(pda.getInitialConfiguration());
+  prune(initial, maxLength);
+  std::set<Configuration> root = pda.epsilonClosure(initial, this->maxStackHeight, &truncated);
+  prune(root, maxLength);
+  if (root.empty()) {
+    return;
+  }
+  intern(root, 0);
+
+  // Nodes are discovered breadth-first, so a node's depth is the length of its shortest
+  // string and only nodes below maxLength need their successors
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i].depth == maxLength) {
+      continue;
+    }
+    nodes[i].next.assign(symbols.size(), DEAD);
+    for (size_t s = 0; s < symbols.size(); ++s) {
+      std::set<Configuration> next = successor(*nodeConfigurations[i], symbols[s], maxLength - nodes[i].depth - 1);
+      if (!next.empty()) {
+        size_t id = intern(next, nodes[i].depth + 1);
+        nodes[i].next[s] = id;
+      }
+    }
+  }
+
+  // N(S, 0) = [S accepting], N(S, n) = sum over the symbols of N(next(S, a), n - 1). A
+  // successor is at most one level deeper, so it always holds the n - 1 entry.
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    nodes[i].exactCounts.assign(maxLength - nodes[i].depth + 1, 0);
+    nodes[i].exactCounts[0] = pda.isAccepting(*nodeConfigurations[i]) ? 1 : 0;
+  }
+  for (size_t n = 1; n <= maxLength; ++n) {
+    for (auto& node : nodes) {
+      if (node.exactCounts.size() <= n) {
+        continue;
+      }
+      uint64_t total = 0;
+      for (size_t next : node.next) {
+        if (next != DEAD) {
+          total = saturatingAdd(total, nodes[next].exactCounts[n - 1]);
+        }
+      }
+      node.exactCounts[n] = total;
+    }
+  }
+}
+
+size_t LanguageGenerator::intern(const std::set<Configuration>& configurations, size_t depth) {
+  auto inserted = nodeIds.insert(std::make_pair(configurations, nodes.size()));
+  if (inserted.second) {
+    Node node;
+    node.depth = depth;
+    nodes.push_back(node);
+    nodeConfigurations.push_back(&inserted.first->first);
+  }
+  return inserted.first->second;
+}
+
+// Epsilon-closed set of configurations after reading symbol, honouring the stack bound and
+// keeping only those that can still accept within remaining symbols
+std::set<Configuration> LanguageGenerator::successor(const std::set<Configuration>& configurations, Symbol symbol,
+                                                     size_t remaining) {
+  std::set<Configuration> next = pda.step(configurations, symbol);
+  prune(next, remaining);
+  if (maxStackHeight > 0) {
+    for (auto it = next.begin(); it != next.end();) {
+      if (it->getStack().size() > maxStackHeight) {
+        it = next.erase(it);
+        truncated = true;
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+  std::set<Configuration> closure = pda.epsilonClosure(next, maxStackHeight, &truncated);
+  prune(closure, remaining);
+  return closure;
+}
+
+// Drops the configurations whose shortest accepted continuation reads more than remaining
+// symbols: they cannot contribute to any string within the bound
+void LanguageGenerator::prune(std::set<Configuration>& configurations, size_t remaining) const {
+  for (auto it = configurations.begin(); it != configurations.end();) {
+    if (completion.distance(*it) > remaining) {
+      it = configurations.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+uint64_t LanguageGenerator::countStrings() const {
+  uint64_t total = 0;
+  if (!nodes.empty()) {
+    for (uint64_t count : nodes[0].exactCounts) {
+      total = saturatingAdd(total, count);
+    }
+  }
+  return total;
+}
+
+size_t LanguageGenerator::enumerate(std::ostream& out, size_t limit) const {
+  size_t written = 0;
+  if (nodes.empty()) {
+    return written;
+  }
+  SymbolString prefix;
+  std::string buffer;
+  buffer.reserve(BUFFER_LIMIT + 4096);
+  for (size_t length = 0; length <= maxLength && (limit == 0 || written < limit); ++length) {
+    if (nodes[0].exactCounts[length] > 0) {
+      enumerateFrom(0, length, prefix, buffer, out, limit, written);
+    }
+  }
+  out.write(buffer.data(), buffer.size());
+  out.flush();
+  return written;
+}
+
+// Only branches with at least one accepted completion of the remaining length are entered, so
+// every call ends up writing a string
+void LanguageGenerator::enumerateFrom(size_t node, size_t remaining, SymbolString& prefix, std::string& buffer,
+                                      std::ostream& out, size_t limit, size_t& written) const {
+  if (remaining == 0) {
+    appendSymbols(buffer, prefix);
+    buffer += '\n';
+    written++;
+    if (buffer.size() >= BUFFER_LIMIT) {
+      out.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+    return;
+  }
+  const Node& current = nodes[node];
+  for (size_t s = 0; s < symbols.size() && (limit == 0 || written < limit); ++s) {
+    size_t next = current.next[s];
+    if (next == DEAD || nodes[next].exactCounts[remaining - 1] == 0) {
+      continue;
+    }
+    prefix.push_back(symbols[s]);
+    enumerateFrom(next, remaining - 1, prefix, buffer, out, limit, written);
+    prefix.pop_back();
+  }
+}
+
+// A single draw r in [0, total) selects the string: the length is chosen by subtracting the
+// counts of each length, and every symbol by subtracting the counts of the earlier siblings
+bool LanguageGenerator::sample(std::ostream& out, size_t count, uint64_t seed) const {
+  uint64_t total = countStrings();
+  if (total == SATURATED) {
+    return false;
+  }
+  if (total == 0) {
+    return true;
+  }
+  std::mt19937_64 generator(seed);
+  std::uniform_int_distribution<uint64_t> distribution(0, total - 1);
+  std::string buffer;
+  buffer.reserve(BUFFER_LIMIT + 4096);
+
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t r = distribution(generator);
+    size_t remaining = 0;
+    while (r >= nodes[0].exactCounts[remaining]) {
+      r -= nodes[0].exactCounts[remaining];
+      remaining++;
+    }
+    size_t node = 0;
+    while (remaining > 0) {
+      const Node& current = nodes[node];
+      for (size_t s = 0; s < symbols.size(); ++s) {
+        size_t next = current.next[s];
+        if (next == DEAD) {
+          continue;
+        }
+        uint64_t below = nodes[next].exactCounts[remaining - 1];
+        if (r < below) {
+          buffer += symbolToText(symbols[s]);
+          node = next;
+          break;
+        }
+        r -= below;
+      }
+      remaining--;
+    }
+    buffer += '\n';
+    if (buffer.size() >= BUFFER_LIMIT) {
+      out.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+  out.write(buffer.data(), buffer.size());
+  out.flush();
+  return true;
+}
+
+bool LanguageGenerator::isTruncated() const {
+  return truncated;
+}
+
+size_t LanguageGenerator::getNodeCount() const {
+  return nodes.size();
+}
@@ -6,7 +6,8 @@
 
 // Constructor
 PDA::PDA(bool useFinalStateAcceptance)
-  : useFinalStateAcceptance(useFinalStateAcceptance)
+  : attemptCounts(nullptr),
+    useFinalStateAcceptance(useFinalStateAcceptance)
 {
 }
 
@@ -16,12 +17,12 @@ void PDA::addState(const std::string& stateName)
   states.insert(State(stateName));
 }
 
-void PDA::addInputSymbol(char symbol)
+void PDA::addInputSymbol(Symbol symbol)
 {
   inputAlphabet.insert(symbol);
 }
 
-void PDA::addStackSymbol(char symbol)
+void PDA::addStackSymbol(Symbol symbol)
 {
   stackAlphabet.insert(symbol);
 }
@@ -31,7 +32,7 @@ void PDA::setInitialState(const std::string& stateName)
   initialState = State(stateName);
 }
 
-void PDA::setInitialStackSymbol(char symbol)
+void PDA::setInitialStackSymbol(Symbol symbol)
 {
   initialStackSymbol = symbol;
 }
@@ -41,24 +42,25 @@ void PDA::addFinalState(const std::string& stateName)
   finalStates.insert(State(stateName));
 }
 
-void PDA::addTransition(const std::string& currentState, char inputSymbol, char stackSymbol,
-  const std::string& nextState, const std::string& symbolsToPush)
+void PDA::addTransition(const std::string& currentState, Symbol inputSymbol, Symbol stackSymbol,
+  const std::string& nextState, const SymbolString& symbolsToPush)
 {
-  transitions.push_back(Transition(State(currentState), inputSymbol, stackSymbol,
-    State(nextState), symbolsToPush));
+  State source(currentState);
+  transitionsByState[source].push_back(transitions.size());
+  transitions.push_back(Transition(source, inputSymbol, stackSymbol, State(nextState), symbolsToPush));
 }
 
-std::set<char> PDA::getInputAlphabet() const
+const std::set<Symbol>& PDA::getInputAlphabet() const
 {
   return inputAlphabet;
 }
 
-std::set<State> PDA::getStates() const
+const std::set<State>& PDA::getStates() const
 {
   return states;
 }
 
-std::set<char> PDA::getStackAlphabet() const
+const std::set<Symbol>& PDA::getStackAlphabet() const
 {
   return stackAlphabet;
 }
@@ -68,14 +70,61 @@ bool PDA::getUseFinalStateAcceptance() const
 return useFinalStateAcceptance;
 }
 // Processing input strings
-bool PDA::processInput(const std::string& input)
+bool PDA::processInput(const SymbolString& input)
 {
+  std::vector<size_t> path;
   Stack stack(initialStackSymbol);
-  return processRecursive(initialState, input, stack);
+  return processRecursive(initialState, input, stack, path);
 }
 
+// Same search as processInput, additionally returning the indices (in definition order) of the
+// transitions along the accepting path. The path is kept as the search descends, so the only
+// extra cost is a push and a pop per explored transition.
+bool PDA::processInputWitness(const SymbolString& input, std::vector<size_t>& witness)
+{
+  witness.clear();
+  Stack stack(initialStackSymbol);
+  return processRecursive(initialState, input, stack, witness);
+}
+
+// Replays a witness and checks that it is an accepting computation for the input
+bool PDA::checkWitness(const SymbolString& input, const std::vector<size_t>& witness) const
+{
+  State currentState = initialState;
+  Stack stack(initialStackSymbol);
+  size_t position = 0;
+
+  for (size_t index : witness)
+  {
+    if (index >= transitions.size())
+    {
+      return false;
+    }
+    const Transition& transition = transitions[index];
+    if (!(transition.getCurrentState() == currentState))
+    {
+      return false;
+    }
+    if (transition.getInputSymbol() != '\0')
+    {
+      if (position >= input.size() || input[position] != transition.getInputSymbol())
+      {
+        return false;
+      }
+      position++;
+    }
+    if (!applyStackOperation(transition, stack))
+    {
+      return false;
+    }
+    currentState = transition.getNextState();
+  }
 
-bool PDA::processRecursive(const State& currentState, const std::string& remainingInput, Stack& stack)
+  return position == input.size() && isAccepting(Configuration(currentState, stack));
+}
+
+bool PDA::processRecursive(const State& currentState, const SymbolString& remainingInput, Stack& stack,
+  std::vector<size_t>& path)
 {
   // Base case: check acceptance
   if (remainingInput.empty())
@@ -97,23 +146,20 @@ bool PDA::processRecursive(const State& currentState, const std::string& remaini
   }
 
   // Get the possible transitions from the current state
-  char inputSymbol = remainingInput.empty() ? '\0' : remainingInput[0];
-  char stackSymbol = stack.isEmpty() ? '\0' : stack.peek();
+  Symbol inputSymbol = remainingInput.empty() ? '\0' : remainingInput[0];
+  Symbol stackSymbol = stack.isEmpty() ? '\0' : stack.peek();
 
-  // Consider both the current input symbol and epsilon (represented as '\0')
-  std::vector<Transition> possibleTransitions = getPossibleTransitions(currentState, inputSymbol, stackSymbol);
-  if (inputSymbol != '\0')
-  {
-    std::vector<Transition> epsilonTransitions = getPossibleTransitions(currentState, '\0', stackSymbol);
-    possibleTransitions.insert(possibleTransitions.end(), epsilonTransitions.begin(), epsilonTransitions.end());
-  }
+  // The candidates include the epsilon-input transitions (represented as '\0'), each once
+  std::vector<size_t> possibleTransitions = getPossibleTransitionIndices(currentState, inputSymbol, stackSymbol);
 
   // Explore each possible transition
-  for (const auto& transition : possibleTransitions)
+  for (size_t index : possibleTransitions)
   {
+    const Transition& transition = transitions[index];
+
     // Copy the stack and input for the new path
     Stack newStack = stack;
-    std::string newRemainingInput = remainingInput;
+    SymbolString newRemainingInput = remainingInput;
 
     // Input consumption
     if (transition.getInputSymbol() != '\0')
@@ -129,36 +175,183 @@ bool PDA::processRecursive(const State& currentState, const std::string& remaini
     }
 
     // Stack operation
-    if (transition.getStackSymbol() != '\0')
+    if (!applyStackOperation(transition, newStack))
     {
-      if (!newStack.isEmpty() && newStack.peek() == transition.getStackSymbol())
+      continue; // Stack symbol does not match
+    }
+
+    if (attemptCounts)
+    {
+      (*attemptCounts)[index]++;
+    }
+
+    // Recursive call
+    path.push_back(index);
+    if (processRecursive(transition.getNextState(), newRemainingInput, newStack, path))
+    {
+      return true;
+    }
+    path.pop_back();
+  }
+
+  // No accepting path found
+  return false;
+}
+
+// Processing input strings under a budget. When any limit runs out the search stops and the
+// verdict is Unknown; stats holds what the search reached either way.
+Verdict PDA::processInput(const SymbolString& input, const SearchBudget& budget, SearchStats& stats)
+{
+  return processBudgeted(input, budget, stats, nullptr);
+}
+
+// Same budgeted search, additionally returning the accepting path as processInputWitness does
+Verdict PDA::processInputWitness(const SymbolString& input, const SearchBudget& budget, SearchStats& stats,
+  std::vector<size_t>& witness)
+{
+  witness.clear();
+  return processBudgeted(input, budget, stats, &witness);
+}
+
+// Same depth-first search as processRecursive, in the same order, but over an explicit stack of
+// frames, so a long epsilon path runs until a budget stops it instead of overflowing the call
+// stack. A configuration (state, position, stack) that repeats one on the current path is not
+// expanded again: the path that reached it first already tries everything it could, so a cycle
+// that keeps the stack height ends by itself and --max-stack alone bounds the search.
+Verdict PDA::processBudgeted(const SymbolString& input, const SearchBudget& budget, SearchStats& stats,
+  std::vector<size_t>* witness)
+{
+  stats = SearchStats();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  bool accepted = false;
+
+  std::vector<SearchFrame> frames;
+  SearchFrame initial = {initialState, 0, Stack(initialStackSymbol), 0, std::vector<size_t>(), 0, false, 0, 0};
+  frames.push_back(initial);
+  std::set<std::pair<size_t, Configuration> > onPath; // Configurations of the frames, by input position
+
+  while (!frames.empty())
+  {
+    SearchFrame& frame = frames.back();
+    if (!frame.expanded)
+    {
+      frame.expanded = true;
+      stats.configurationsExplored++;
+      stats.maxStackHeight = std::max(stats.maxStackHeight, frame.stack.size());
+      stats.peakMemoryBytes = std::max(stats.peakMemoryBytes, frame.memoryInUse);
+      if (exceedsBudget(budget, stats, start, frame.stack.size()))
       {
-        newStack.pop();
+        break;
+      }
+
+      // Base case: check acceptance
+      if (frame.position == input.size() &&
+        (useFinalStateAcceptance ? finalStates.count(frame.state) > 0 : frame.stack.isEmpty()))
+      {
+        accepted = true;
+        break;
+      }
+
+      if (!onPath.insert(std::make_pair(frame.position, Configuration(frame.state, frame.stack))).second)
+      {
+        frames.pop_back(); // A cycle back to a configuration on the path
+        continue;
+      }
+
+      Symbol inputSymbol = frame.position < input.size() ? input[frame.position] : '\0';
+      Symbol stackSymbol = frame.stack.isEmpty() ? '\0' : frame.stack.peek();
+      frame.candidates = getPossibleTransitionIndices(frame.state, inputSymbol, stackSymbol);
+
+      // Memory held by this frame: its pending candidates and its copy of the stack, plus the
+      // entry of its configuration in the path set (another copy of the stack)
+      size_t stackBytes = frame.stack.getContents().capacity() * sizeof(Symbol);
+      frame.frameMemory = sizeof(SearchFrame) + frame.candidates.capacity() * sizeof(size_t) + stackBytes +
+        sizeof(std::pair<size_t, Configuration>) + stackBytes;
+    }
+
+    if (frame.nextCandidate == frame.candidates.size())
+    {
+      onPath.erase(std::make_pair(frame.position, Configuration(frame.state, frame.stack)));
+      frames.pop_back(); // Backtrack
+      continue;
+    }
+    size_t index = frame.candidates[frame.nextCandidate++];
+    const Transition& transition = transitions[index];
+
+    // Input consumption
+    size_t position = frame.position;
+    if (transition.getInputSymbol() != '\0')
+    {
+      if (position < input.size() && input[position] == transition.getInputSymbol())
+      {
+        position++;
       }
       else
       {
-        continue; // Stack symbol does not match
+        continue; // Input symbol does not match
       }
     }
 
-    // Push symbols onto the stack
-    if (!transition.getSymbolsToPush().empty())
+    // Stack operation
+    Stack newStack = frame.stack;
+    if (!applyStackOperation(transition, newStack))
     {
-      newStack.push(transition.getSymbolsToPush());
+      continue; // Stack symbol does not match
     }
 
-    // Recursive call
-    if (processRecursive(transition.getNextState(), newRemainingInput, newStack))
+    if (attemptCounts)
     {
-      return true;
+      (*attemptCounts)[index]++;
     }
+
+    SearchFrame next = {transition.getNextState(), position, newStack, index, std::vector<size_t>(), 0, false,
+      frame.memoryInUse + frame.frameMemory, 0};
+    frames.push_back(std::move(next)); // frame is not used past this point
   }
 
-  // No accepting path found
-  return false;
+  stats.elapsedMilliseconds = static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start).count());
+
+  if (accepted)
+  {
+    if (witness)
+    {
+      for (size_t i = 1; i < frames.size(); ++i)
+      {
+        witness->push_back(frames[i].transition);
+      }
+    }
+    return Verdict::Accepted;
+  }
+  return stats.exceededBudget.empty() ? Verdict::Rejected : Verdict::Unknown;
+}
+
+// Checks every limit of the budget, recording the first one that ran out
+bool PDA::exceedsBudget(const SearchBudget& budget, SearchStats& stats,
+  const std::chrono::steady_clock::time_point& start, size_t stackHeight)
+{
+  if (budget.getMaxConfigurations() > 0 && stats.configurationsExplored > budget.getMaxConfigurations())
+  {
+    stats.exceededBudget = "configurations";
+  }
+  else if (budget.getMaxStackHeight() > 0 && stackHeight > budget.getMaxStackHeight())
+  {
+    stats.exceededBudget = "stack height";
+  }
+  else if (budget.getMaxMemoryBytes() > 0 && stats.peakMemoryBytes > budget.getMaxMemoryBytes())
+  {
+    stats.exceededBudget = "memory";
+  }
+  // Reading the clock is comparatively expensive, so it is only sampled periodically
+  else if (budget.getMaxMilliseconds() > 0 && (stats.configurationsExplored & 0x3FF) == 0 &&
+    std::chrono::steady_clock::now() - start > std::chrono::milliseconds(budget.getMaxMilliseconds()))
+  {
+    stats.exceededBudget = "time";
+  }
+  return !stats.exceededBudget.empty();
 }
 
-bool PDA::processInputTrace(const std::string& input, const std::string& outputMode)
+bool PDA::processInputTrace(const SymbolString& input, const std::string& outputMode)
 {
   Stack stack(initialStackSymbol);
   std::string trace;
@@ -186,14 +379,14 @@ bool PDA::processInputTrace(const std::string& input, const std::string& outputM
   return accepted;
 }
 
-bool PDA::processRecursiveTrace(const State& currentState, const std::string& remainingInput, Stack& stack,
+bool PDA::processRecursiveTrace(const State& currentState, const SymbolString& remainingInput, Stack& stack,
   std::string& trace, int depth)
 {
   // Indentation for the current depth
   std::string indent(depth * 2, ' ');
 
   // Record the current configuration
-  trace += indent + "State: " + currentState.getName() + ", Input: " + remainingInput +
+  trace += indent + "State: " + currentState.getName() + ", Input: " + symbolsToText(remainingInput) +
     ", Stack: " + stack.display();
 
   trace += "\n";
@@ -216,29 +409,24 @@ bool PDA::processRecursiveTrace(const State& currentState, const std::string& re
   bool accepted = false;
 
   // Get the possible transitions from the current state
-  char inputSymbol = remainingInput.empty() ? '\0' : remainingInput[0];
-  char stackSymbol = stack.isEmpty() ? '\0' : stack.peek();
+  Symbol inputSymbol = remainingInput.empty() ? '\0' : remainingInput[0];
+  Symbol stackSymbol = stack.isEmpty() ? '\0' : stack.peek();
 
-  // Consider both the current input symbol and epsilon
+  // The candidates include the epsilon-input transitions, each once
   std::vector<Transition> possibleTransitions = getPossibleTransitions(currentState, inputSymbol, stackSymbol);
-  if (inputSymbol != '\0')
-  {
-    std::vector<Transition> epsilonTransitions = getPossibleTransitions(currentState, '\0', stackSymbol);
-    possibleTransitions.insert(possibleTransitions.end(), epsilonTransitions.begin(), epsilonTransitions.end());
-  }
 
   // Explore each possible transition
   for (const auto& transition : possibleTransitions)
   {
     // Copy the stack and input for the new path
     Stack newStack = stack;
-    std::string newRemainingInput = remainingInput;
+    SymbolString newRemainingInput = remainingInput;
     std::string transitionInfo = indent + "Applying transition: (" + transition.getCurrentState().getName() + ", ";
 
     // Input consumption
     if (transition.getInputSymbol() != '\0')
     {
-      transitionInfo += transition.getInputSymbol();
+      transitionInfo += symbolToText(transition.getInputSymbol());
       if (!newRemainingInput.empty() && newRemainingInput[0] == transition.getInputSymbol())
       {
         newRemainingInput = newRemainingInput.substr(1);
@@ -258,7 +446,7 @@ bool PDA::processRecursiveTrace(const State& currentState, const std::string& re
     // Stack operation
     if (transition.getStackSymbol() != '\0')
     {
-      transitionInfo += transition.getStackSymbol();
+      transitionInfo += symbolToText(transition.getStackSymbol());
       if (!newStack.isEmpty() && newStack.peek() == transition.getStackSymbol())
       {
         newStack.pop();
@@ -276,7 +464,7 @@ bool PDA::processRecursiveTrace(const State& currentState, const std::string& re
     transitionInfo += ") -> (" + transition.getNextState().getName() + ", ";
 
     // Symbols to push
-    transitionInfo += transition.getSymbolsToPush().empty() ? "ε" : transition.getSymbolsToPush();
+    transitionInfo += transition.getSymbolsToPush().empty() ? "ε" : symbolsToText(transition.getSymbolsToPush());
     transitionInfo += ")";
 
     trace += transitionInfo + "\n";
@@ -303,31 +491,230 @@ bool PDA::processRecursiveTrace(const State& currentState, const std::string& re
   return accepted;
 }
 
-std::vector<Transition> PDA::getPossibleTransitions(const State& state, char inputSymbol, char stackSymbol)
+std::vector<Transition> PDA::getPossibleTransitions(const State& state, Symbol inputSymbol, Symbol stackSymbol)
 {
   std::vector<Transition> possibleTransitions;
-  for (const auto& transition : transitions)
+  for (size_t index : getPossibleTransitionIndices(state, inputSymbol, stackSymbol))
+  {
+    possibleTransitions.push_back(transitions[index]);
+  }
+  return possibleTransitions;
+}
+
+// Candidates come from the dispatch bucket of the state, in bucket order (definition order
+// unless a profile has been applied with reorderTransitions). Transitions that read no input or
+// match any stack top are included, so for inputSymbol '\0' only those remain.
+std::vector<size_t> PDA::getPossibleTransitionIndices(const State& state, Symbol inputSymbol, Symbol stackSymbol) const
+{
+  std::vector<size_t> possibleTransitions;
+  auto bucket = transitionsByState.find(state);
+  if (bucket == transitionsByState.end())
+  {
+    return possibleTransitions;
+  }
+  for (size_t index : bucket->second)
   {
-    if (transition.getCurrentState() == state)
+    const Transition& transition = transitions[index];
+    bool inputMatches = (transition.getInputSymbol() == inputSymbol);
+    bool stackMatches = (transition.getStackSymbol() == stackSymbol);
+
+    // Handle epsilon transitions
+    if (transition.getInputSymbol() == '\0')
+    {
+      inputMatches = true;
+    }
+    if (transition.getStackSymbol() == '\0')
     {
-      bool inputMatches = (transition.getInputSymbol() == inputSymbol);
-      bool stackMatches = (transition.getStackSymbol() == stackSymbol);
+      stackMatches = true;
+    }
 
-      // Handle epsilon transitions
-      if (transition.getInputSymbol() == '\0')
+    if (inputMatches && stackMatches)
+    {
+      possibleTransitions.push_back(index);
+    }
+  }
+  return possibleTransitions;
+}
+
+// Sorts every dispatch bucket by success rate (times on an accepting path / times tried), so a
+// transition that is tried often but rarely succeeds goes after one that nearly always does.
+// Transitions never tried rate 0. Ties keep definition order. Transition indices (and
+// witnesses) are unchanged.
+void PDA::reorderTransitions(const std::vector<size_t>& successCounts, const std::vector<size_t>& attemptCounts)
+{
+  std::vector<double> rates(transitions.size(), 0.0);
+  for (size_t index = 0; index < rates.size(); ++index)
+  {
+    if (index < successCounts.size() && index < attemptCounts.size() && attemptCounts[index] > 0)
+    {
+      rates[index] = static_cast<double>(successCounts[index]) / attemptCounts[index];
+    }
+  }
+  for (auto& bucket : transitionsByState)
+  {
+    std::vector<size_t>& indices = bucket.second;
+    std::stable_sort(indices.begin(), indices.end(), [&rates](size_t a, size_t b) {
+      return rates[a] > rates[b];
+    });
+  }
+}
+
+void PDA::setAttemptCounts(std::vector<size_t>* attemptCounts)
+{
+  this->attemptCounts = attemptCounts;
+}
+
+const std::vector<size_t>& PDA::getDispatchOrder(const State& state) const
+{
+  static const std::vector<size_t> none;
+  auto bucket = transitionsByState.find(state);
+  return bucket == transitionsByState.end() ? none : bucket->second;
+}
+
+const State& PDA::getInitialState() const
+{
+  return initialState;
+}
+
+Symbol PDA::getInitialStackSymbol() const
+{
+  return initialStackSymbol;
+}
+
+const std::set<State>& PDA::getFinalStates() const
+{
+  return finalStates;
+}
+
+const std::vector<Transition>& PDA::getTransitions() const
+{
+  return transitions;
+}
+
+size_t PDA::getTransitionCount() const
+{
+  return transitions.size();
+}
+
+// Configuration-set simulation
+Configuration PDA::getInitialConfiguration() const
+{
+  return Configuration(initialState, Stack(initialStackSymbol));
+}
+
+bool PDA::isAccepting(const Configuration& configuration) const
+{
+  if (useFinalStateAcceptance)
+  {
+    return finalStates.count(configuration.getState()) > 0;
+  }
+  return configuration.getStack().isEmpty();
+}
+
+bool PDA::isAccepting(const std::set<Configuration>& configurations) const
+{
+  for (const auto& configuration : configurations)
+  {
+    if (isAccepting(configuration))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Adds every configuration reachable through epsilon transitions. Configurations whose stack
+// grows beyond maxStackHeight (0 = unbounded) are dropped, which keeps the closure finite on
+// automata with stack-growing epsilon cycles. If truncated is given it is set when that happens.
+std::set<Configuration> PDA::epsilonClosure(const std::set<Configuration>& configurations,
+  size_t maxStackHeight, bool* truncated) const
+{
+  std::set<Configuration> closure(configurations);
+  std::vector<Configuration> pending(configurations.begin(), configurations.end());
+
+  while (!pending.empty())
+  {
+    Configuration configuration = pending.back();
+    pending.pop_back();
+
+    auto bucket = transitionsByState.find(configuration.getState());
+    if (bucket == transitionsByState.end())
+    {
+      continue;
+    }
+    for (size_t index : bucket->second)
+    {
+      const Transition& transition = transitions[index];
+      if (transition.getInputSymbol() != '\0')
+      {
+        continue;
+      }
+      Stack newStack = configuration.getStack();
+      if (!applyStackOperation(transition, newStack))
       {
-        inputMatches = true;
+        continue;
       }
-      if (transition.getStackSymbol() == '\0')
+      if (maxStackHeight > 0 && newStack.size() > maxStackHeight)
       {
-        stackMatches = true;
+        if (truncated)
+        {
+          *truncated = true;
+        }
+        continue;
       }
+      Configuration next(transition.getNextState(), newStack);
+      if (closure.insert(next).second)
+      {
+        pending.push_back(next);
+      }
+    }
+  }
+  return closure;
+}
 
-      if (inputMatches && stackMatches)
+// Consumes one input symbol from every configuration (no epsilon closure is applied)
+std::set<Configuration> PDA::step(const std::set<Configuration>& configurations, Symbol inputSymbol) const
+{
+  std::set<Configuration> result;
+  for (const auto& configuration : configurations)
+  {
+    auto bucket = transitionsByState.find(configuration.getState());
+    if (bucket == transitionsByState.end())
+    {
+      continue;
+    }
+    for (size_t index : bucket->second)
+    {
+      const Transition& transition = transitions[index];
+      if (transition.getInputSymbol() != inputSymbol)
       {
-        possibleTransitions.push_back(transition);
+        continue;
+      }
+      Stack newStack = configuration.getStack();
+      if (applyStackOperation(transition, newStack))
+      {
+        result.insert(Configuration(transition.getNextState(), newStack));
       }
     }
   }
-  return possibleTransitions;
+  return result;
+}
+
+// Pops the transition's stack symbol (if any) and pushes its replacement.
+// Returns false if the top of the stack does not match.
+bool PDA::applyStackOperation(const Transition& transition, Stack& stack)
+{
+  if (transition.getStackSymbol() != '\0')
+  {
+    if (stack.isEmpty() || stack.peek() != transition.getStackSymbol())
+    {
+      return false;
+    }
+    stack.pop();
+  }
+  if (!transition.getSymbolsToPush().empty())
+  {
+    stack.push(transition.getSymbolsToPush());
+  }
+  return true;
 }
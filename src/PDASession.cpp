@@ -0,0 +1,251 @@
+#include "../include/PDASession.h"
+#include "../include/ViabilityAutomaton.h"
+#include "../include/AutomatonAnalyzer.h"
+#include <map>
+#include <algorithm>
+
+// Transitions by source state, the viability automaton and the interned stack cells
+struct PDASession::Engine {
+  struct Move {
+    Symbol input;
+    Symbol pop;
+    size_t next;
+    SymbolString push;
+  };
+
+  Engine(const PDA& pda, size_t maxStackHeight);
+  CellPointer push(const CellPointer& below, Symbol symbol);
+  void sweep();
+  bool isViable(const Live& configuration) const;
+  bool apply(const Live& configuration, const Move& move, Live& result, bool& truncated);
+
+  ViabilityAutomaton viability;
+  std::vector<std::vector<Move> > moves;
+  std::set<Symbol> readSymbols; // Read by some transition
+  std::vector<bool> finalStates;
+  bool useFinalStateAcceptance;
+  std::vector<bool> viableOnEmptyStack;
+  size_t maxStackHeight;
+  Live initial;
+  // Interned cells by (symbol, cell below). The index does not keep cells alive: entries of freed
+  // cells are swept once the index has doubled since the last sweep.
+  std::map<std::pair<Symbol, const Cell*>, std::weak_ptr<Cell> > cellIndex;
+  size_t sweepThreshold;
+};
+
+PDASession::Engine::Engine(const PDA& pda, size_t maxStackHeight)
+  : viability(pda),
+    moves(pda.getStates().size()),
+    finalStates(pda.getStates().size(), false),
+    useFinalStateAcceptance(pda.getUseFinalStateAcceptance()),
+    viableOnEmptyStack(viability.viableOnEmptyStack()),
+    maxStackHeight(AutomatonAnalyzer::closureStackBound(pda, maxStackHeight)),
+    sweepThreshold(1024) {
+  for (const auto& transition : pda.getTransitions()) {
+    Move move;
+    move.input = transition.getInputSymbol();
+    move.pop = transition.getStackSymbol();
+    move.next = viability.getStateIndex(transition.getNextState());
+    move.push = transition.getSymbolsToPush();
+    moves[viability.getStateIndex(transition.getCurrentState())].push_back(move);
+    if (move.input != '\0') {
+      readSymbols.insert(move.input);
+    }
+  }
+  for (const auto& state : pda.getFinalStates()) {
+    finalStates[viability.getStateIndex(state)] = true;
+  }
+  initial = Live(viability.getStateIndex(pda.getInitialState()), push(CellPointer(), pda.getInitialStackSymbol()));
+}
+
+// Equal stacks are the same cell, so configurations compare by pointer
+PDASession::CellPointer PDASession::Engine::push(const CellPointer& below, Symbol symbol) {
+  std::weak_ptr<Cell>& entry = cellIndex[std::make_pair(symbol, below.get())];
+  CellPointer cell = entry.lock();
+  if (cell) {
+    return cell;
+  }
+  cell = std::make_shared<Cell>();
+  cell->symbol = symbol;
+  cell->below = below;
+  cell->height = below ? below->height + 1 : 1;
+  cell->viable = viability.viableOnPush(symbol, below ? below->viable : viableOnEmptyStack);
+  entry = cell;
+  if (cellIndex.size() >= sweepThreshold) {
+    sweep();
+    sweepThreshold = std::max<size_t>(1024, 2 * cellIndex.size());
+  }
+  return cell;
+}
+
+// Drops the index entries of cells no configuration holds any more. A freed cell frees every
+// cell above it first, so a stale key is never mistaken for a live cell at a reused address.
+void PDASession::Engine::sweep() {
+  for (auto it = cellIndex.begin(); it != cellIndex.end();) {
+    if (it->second.expired()) {
+      it = cellIndex.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+// Unlinks the cells below that only this one holds one by one, so dropping a deep stack does not
+// recurse once per cell
+PDASession::Cell::~Cell() {
+  CellPointer next = std::move(below);
+  while (next && next.use_count() == 1) {
+    CellPointer after = std::move(next->below);
+    next = std::move(after);
+  }
+}
+
+bool PDASession::Engine::isViable(const Live& configuration) const {
+  return configuration.second ? configuration.second->viable[configuration.first]
+                              : viableOnEmptyStack[configuration.first];
+}
+
+// Same stack operation as PDA::applyStackOperation; false if the top does not match or the
+// stack exceeds the bound. Only discarding a configuration that could still accept counts as
+// truncation.
+bool PDASession::Engine::apply(const Live& configuration, const Move& move, Live& result, bool& truncated) {
+  CellPointer stack = configuration.second;
+  if (move.pop != '\0') {
+    if (!stack || stack->symbol != move.pop) {
+      return false;
+    }
+    stack = stack->below;
+  }
+  for (auto it = move.push.rbegin(); it != move.push.rend(); ++it) {
+    stack = push(stack, *it);
+  }
+  result = Live(move.next, std::move(stack));
+  if (maxStackHeight > 0 && result.second && result.second->height > maxStackHeight) {
+    truncated = truncated || isViable(result);
+    return false;
+  }
+  return true;
+}
+
+PDASession::PDASession(const PDA& pda, size_t maxStackHeight)
+  : engine(std::make_shared<Engine>(pda, maxStackHeight)),
+    position(0),
+    truncated(false) {
+  std::set<Live> initial;
+  initial.insert(engine->initial);
+  configurations = viableClosure(initial);
+}
+
+// Epsilon closure keeping only the configurations that can still accept. Whatever is reachable
+// from a configuration that cannot accept cannot accept either, so those are not expanded.
+PDASession::LiveSet PDASession::viableClosure(std::set<Live> configurations) {
+  for (auto it = configurations.begin(); it != configurations.end();) {
+    if (engine->isViable(*it)) {
+      ++it;
+    }
+    else {
+      it = configurations.erase(it);
+    }
+  }
+  std::vector<Live> pending(configurations.begin(), configurations.end());
+  while (!pending.empty()) {
+    Live configuration = pending.back();
+    pending.pop_back();
+    for (const auto& move : engine->moves[configuration.first]) {
+      Live next;
+      if (move.input == '\0' && engine->apply(configuration, move, next, truncated) && engine->isViable(next) &&
+          configurations.insert(next).second) {
+        pending.push_back(next);
+      }
+    }
+  }
+  return std::make_shared<const std::set<Live> >(std::move(configurations));
+}
+
+PDASession::Status PDASession::feed(Symbol symbol) {
+  position++;
+  if (!engine->readSymbols.count(symbol)) {
+    // No configuration, not even one discarded by the stack bound, could read the symbol
+    if (!configurations->empty()) {
+      configurations = std::make_shared<const std::set<Live> >();
+    }
+    truncated = false;
+  }
+  else if (!configurations->empty()) {
+    std::set<Live> next;
+    for (const auto& configuration : *configurations) {
+      for (const auto& move : engine->moves[configuration.first]) {
+        Live result;
+        if (move.input == symbol && engine->apply(configuration, move, result, truncated)) {
+          next.insert(result);
+        }
+      }
+    }
+    configurations = viableClosure(next);
+  }
+  return status();
+}
+
+PDASession::Status PDASession::feed(const SymbolString& symbols) {
+  for (Symbol symbol : symbols) {
+    feed(symbol);
+  }
+  return status();
+}
+
+PDASession::Status PDASession::status() const {
+  for (const auto& configuration : *configurations) {
+    if (engine->useFinalStateAcceptance ? engine->finalStates[configuration.first] : configuration.second == nullptr) {
+      return ACCEPT;
+    }
+  }
+  return configurations->empty() ? DEAD : VIABLE_PREFIX;
+}
+
+PDASession::Snapshot PDASession::snapshot() const {
+  Snapshot snapshot;
+  snapshot.configurations = configurations;
+  snapshot.position = position;
+  snapshot.truncated = truncated;
+  return snapshot;
+}
+
+void PDASession::restore(const Snapshot& snapshot) {
+  configurations = snapshot.configurations;
+  position = snapshot.position;
+  truncated = snapshot.truncated;
+}
+
+PDASession PDASession::fork() const {
+  return *this;
+}
+
+size_t PDASession::getPosition() const {
+  return position;
+}
+
+size_t PDASession::getConfigurationCount() const {
+  return configurations->size();
+}
+
+size_t PDASession::getCellCount() const {
+  engine->sweep();
+  return engine->cellIndex.size();
+}
+
+bool PDASession::isTruncated() const {
+  return truncated;
+}
+
+std::string PDASession::toString(Status status) {
+  switch (status) {
+    case ACCEPT:
+      return "Accept";
+    case VIABLE_PREFIX:
+      return "Viable prefix";
+    case DEAD:
+      return "Dead";
+  }
+  return "";
+}
@@ -0,0 +1,192 @@
+#include "../include/ResultCache.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+
+// 64-bit FNV-1a
+static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t hashBytes(const std::string& bytes, uint64_t hash = FNV_OFFSET) {
+  for (char byte : bytes) {
+    hash ^= static_cast<unsigned char>(byte);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+ResultCache::ResultCache(uint64_t fingerprint)
+  : automatonFingerprint(fingerprint),
+    hits(0) {}
+
+// Length-prefixed field, so that no two sequences of fields give the same text
+static std::string field(const std::string& text) {
+  return std::to_string(text.size()) + ':' + text;
+}
+
+uint64_t ResultCache::fingerprint(const PDA& pda) {
+  // Every name and symbol is written as a length-prefixed field: the text of a symbol can be
+  // several characters long (<NNN>) and would otherwise run into its neighbours. The symbol width
+  // goes in too: the same definition reads differently in 8, 16 and 32-bit builds.
+  std::string normalized = "bits " + std::to_string(PDA_SYMBOL_BITS) + '\n';
+  normalized += pda.getUseFinalStateAcceptance() ? "apf\n" : "apv\n";
+  for (const auto& state : pda.getStates()) {
+    normalized += field(state.getName());
+  }
+  normalized += '\n';
+  for (Symbol symbol : pda.getInputAlphabet()) {
+    normalized += field(symbolToText(symbol));
+  }
+  normalized += '\n';
+  for (Symbol symbol : pda.getStackAlphabet()) {
+    normalized += field(symbolToText(symbol));
+  }
+  normalized += '\n';
+  normalized += field(pda.getInitialState().getName()) + field(symbolToText(pda.getInitialStackSymbol())) + '\n';
+  if (pda.getUseFinalStateAcceptance()) {
+    for (const auto& state : pda.getFinalStates()) {
+      normalized += field(state.getName());
+    }
+  }
+  normalized += '\n';
+
+  std::vector<std::string> transitions;
+  for (const auto& transition : pda.getTransitions()) {
+    std::string line = field(transition.getCurrentState().getName());
+    line += field(symbolToText(transition.getInputSymbol()));
+    line += field(symbolToText(transition.getStackSymbol()));
+    line += field(transition.getNextState().getName());
+    line += std::to_string(transition.getSymbolsToPush().size()) + ':';
+    for (Symbol symbol : transition.getSymbolsToPush()) {
+      line += field(symbolToText(symbol));
+    }
+    transitions.push_back(line);
+  }
+  std::sort(transitions.begin(), transitions.end());
+  for (const auto& line : transitions) {
+    normalized += line + '\n';
+  }
+  return hashBytes(normalized);
+}
+
+// Every byte of each symbol value, lowest first (one byte per symbol in 8-bit builds)
+uint64_t ResultCache::hashInput(const SymbolString& input) {
+  uint64_t hash = FNV_OFFSET;
+  for (Symbol symbol : input) {
+    uint32_t value = symbolValue(symbol);
+    for (size_t byte = 0; byte < sizeof(Symbol); ++byte) {
+      hash ^= (value >> (8 * byte)) & 0xFF;
+      hash *= FNV_PRIME;
+    }
+  }
+  return hash;
+}
+
+bool ResultCache::lookup(const SymbolString& input, Verdict& verdict) {
+  auto entry = verdicts.find(input);
+  if (entry == verdicts.end()) {
+    return false;
+  }
+  hits++;
+  verdict = entry->second ? Verdict::Accepted : Verdict::Rejected;
+  return true;
+}
+
+void ResultCache::store(const SymbolString& input, Verdict verdict) {
+  if (verdict != Verdict::Unknown) {
+    verdicts[input] = verdict == Verdict::Accepted;
+  }
+}
+
+// Each symbol is written as fixed-width hex (two digits per byte of the symbol type), so any
+// input, including the empty one, fits on one line
+static const size_t SYMBOL_DIGITS = 2 * sizeof(Symbol);
+
+static bool parseInput(const std::string& text, SymbolString& input) {
+  if (text.size() % SYMBOL_DIGITS != 0 || text.find_first_not_of("0123456789abcdef") != std::string::npos) {
+    return false;
+  }
+  input.clear();
+  for (size_t i = 0; i < text.size(); i += SYMBOL_DIGITS) {
+    uint32_t value = static_cast<uint32_t>(std::strtoul(text.substr(i, SYMBOL_DIGITS).c_str(), nullptr, 16));
+    input += static_cast<Symbol>(value);
+  }
+  return true;
+}
+
+// File format: a "fingerprint <hex>" line followed by "<A|R> <input in hex>" lines
+bool ResultCache::load(const std::string& filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    return false; // No cache yet
+  }
+
+  std::string line;
+  std::istringstream header(std::getline(file, line) ? line : "");
+  std::string key;
+  std::string value;
+  header >> key >> value;
+  if (key != "fingerprint" || value.empty() || value.find_first_not_of("0123456789abcdef") != std::string::npos) {
+    std::cerr << "Warning: Corrupt cache file '" << filename << "' (line 1); it is ignored." << std::endl;
+    return false;
+  }
+  if (std::strtoull(value.c_str(), nullptr, 16) != automatonFingerprint) {
+    return false; // Written for another automaton
+  }
+
+  SymbolString input;
+  size_t lineNumber = 1;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    if (line.size() < 2 || (line[0] != 'A' && line[0] != 'R') || line[1] != ' ' || !parseInput(line.substr(2), input)) {
+      std::cerr << "Warning: Corrupt cache file '" << filename << "' (line " << lineNumber << "); it is ignored."
+                << std::endl;
+      verdicts.clear();
+      return false;
+    }
+    verdicts[input] = line[0] == 'A';
+  }
+  return true;
+}
+
+bool ResultCache::save(const std::string& filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error opening cache file: " << filename << std::endl;
+    return false;
+  }
+
+  std::string buffer;
+  char digits[32];
+  std::snprintf(digits, sizeof(digits), "%016llx", static_cast<unsigned long long>(automatonFingerprint));
+  buffer += "fingerprint ";
+  buffer += digits;
+  buffer += '\n';
+  for (const auto& entry : verdicts) {
+    buffer += entry.second ? "A " : "R ";
+    for (Symbol symbol : entry.first) {
+      std::snprintf(digits, sizeof(digits), "%0*x", static_cast<int>(SYMBOL_DIGITS), symbolValue(symbol));
+      buffer += digits;
+    }
+    buffer += '\n';
+  }
+  file << buffer;
+  file.close();
+  if (!file.good()) {
+    std::cerr << "Error writing cache file: " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+size_t ResultCache::getHits() const {
+  return hits;
+}
+
+size_t ResultCache::getSize() const {
+  return verdicts.size();
+}
@@ -0,0 +1,180 @@
+#include "../include/ResultWriter.h"
+
+const size_t ResultWriter::BUFFER_LIMIT;
+
+// Details on one line: trailing newline dropped, inner newlines joined with "; "
+static std::string singleLine(const std::string& details) {
+  std::string line;
+  for (size_t i = 0; i < details.size(); ++i) {
+    if (details[i] != '\n') {
+      line += details[i];
+    }
+    else if (i + 1 < details.size()) {
+      line += "; ";
+    }
+  }
+  return line;
+}
+
+static void appendCsvField(std::string& buffer, const std::string& field) {
+  if (field.find_first_of(",\"") == std::string::npos) {
+    buffer += field;
+    return;
+  }
+  buffer += '"';
+  for (char c : field) {
+    buffer += c;
+    if (c == '"') {
+      buffer += '"';
+    }
+  }
+  buffer += '"';
+}
+
+static void appendJsonString(std::string& buffer, const std::string& text) {
+  static const char hex[] = "0123456789abcdef";
+  buffer += '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      buffer += '\\';
+      buffer += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20) {
+      buffer += "\\u00";
+      buffer += hex[(c >> 4) & 0xF];
+      buffer += hex[c & 0xF];
+    }
+    else {
+      buffer += c;
+    }
+  }
+  buffer += '"';
+}
+
+ResultWriter::ResultWriter(std::ostream& out, OutputFormat format)
+  : out(out),
+    format(format),
+    accepted(0),
+    rejected(0),
+    unknown(0),
+    start(std::chrono::steady_clock::now()) {
+  buffer.reserve(BUFFER_LIMIT + 4096);
+  if (format == OutputFormat::Csv) {
+    buffer += "index,verdict,details\n";
+  }
+}
+
+ResultWriter::~ResultWriter() {
+  flush();
+}
+
+bool ResultWriter::parseFormat(const std::string& name, OutputFormat& format) {
+  if (name == "text") {
+    format = OutputFormat::Text;
+  }
+  else if (name == "compact") {
+    format = OutputFormat::Compact;
+  }
+  else if (name == "csv") {
+    format = OutputFormat::Csv;
+  }
+  else if (name == "jsonl") {
+    format = OutputFormat::JsonLines;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+void ResultWriter::beginInput(const SymbolString& input) {
+  if (format == OutputFormat::Text) {
+    buffer += "Processing input: ";
+    appendSymbols(buffer, input);
+    buffer += '\n';
+  }
+}
+
+void ResultWriter::writeResult(size_t index, Verdict verdict, const std::string& details) {
+  const char* name = "rejected";
+  if (verdict == Verdict::Accepted) {
+    accepted++;
+    name = "accepted";
+  }
+  else if (verdict == Verdict::Unknown) {
+    unknown++;
+    name = "unknown";
+  }
+  else {
+    rejected++;
+  }
+
+  switch (format) {
+  case OutputFormat::Text:
+    if (verdict == Verdict::Accepted) {
+      buffer += "Result: Accepted\n";
+    }
+    else if (verdict == Verdict::Unknown) {
+      buffer += "Result: Unknown (budget exceeded)\n";
+    }
+    else {
+      buffer += "Result: Rejected\n";
+    }
+    buffer += details;
+    buffer += '\n';
+    break;
+  case OutputFormat::Compact:
+    buffer += std::to_string(index);
+    buffer += ' ';
+    buffer += name;
+    if (!details.empty()) {
+      buffer += ' ';
+      buffer += singleLine(details);
+    }
+    buffer += '\n';
+    break;
+  case OutputFormat::Csv:
+    buffer += std::to_string(index);
+    buffer += ',';
+    buffer += name;
+    buffer += ',';
+    appendCsvField(buffer, singleLine(details));
+    buffer += '\n';
+    break;
+  case OutputFormat::JsonLines:
+    buffer += "{\"index\":";
+    buffer += std::to_string(index);
+    buffer += ",\"verdict\":\"";
+    buffer += name;
+    buffer += '"';
+    if (!details.empty()) {
+      buffer += ",\"details\":";
+      appendJsonString(buffer, singleLine(details));
+    }
+    buffer += "}\n";
+    break;
+  }
+
+  if (buffer.size() >= BUFFER_LIMIT) {
+    flush();
+  }
+}
+
+void ResultWriter::flush() {
+  if (!buffer.empty()) {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+  }
+  out.flush();
+}
+
+void ResultWriter::writeSummary(std::ostream& summaryOut) {
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  size_t total = accepted + rejected + unknown;
+  summaryOut << "Summary: " << total << " inputs, " << accepted << " accepted, " << rejected << " rejected, "
+             << unknown << " unknown, " << static_cast<size_t>(seconds * 1000.0) << " ms";
+  if (seconds > 0.0) {
+    summaryOut << ", " << static_cast<size_t>(total / seconds) << " inputs/s";
+  }
+  summaryOut << "\n";
+}
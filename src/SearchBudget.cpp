@@ -0,0 +1,64 @@
+#include "../include/SearchBudget.h"
+#include <sstream>
+
+SearchBudget::SearchBudget()
+  : maxConfigurations(0),
+    maxMilliseconds(0),
+    maxStackHeight(0),
+    maxMemoryBytes(0) {}
+
+// Setters
+void SearchBudget::setMaxConfigurations(size_t maxConfigurations) {
+  this->maxConfigurations = maxConfigurations;
+}
+
+void SearchBudget::setMaxMilliseconds(size_t maxMilliseconds) {
+  this->maxMilliseconds = maxMilliseconds;
+}
+
+void SearchBudget::setMaxStackHeight(size_t maxStackHeight) {
+  this->maxStackHeight = maxStackHeight;
+}
+
+void SearchBudget::setMaxMemoryBytes(size_t maxMemoryBytes) {
+  this->maxMemoryBytes = maxMemoryBytes;
+}
+
+// Getters
+size_t SearchBudget::getMaxConfigurations() const {
+  return maxConfigurations;
+}
+
+size_t SearchBudget::getMaxMilliseconds() const {
+  return maxMilliseconds;
+}
+
+size_t SearchBudget::getMaxStackHeight() const {
+  return maxStackHeight;
+}
+
+size_t SearchBudget::getMaxMemoryBytes() const {
+  return maxMemoryBytes;
+}
+
+bool SearchBudget::isLimited() const {
+  return maxConfigurations > 0 || maxMilliseconds > 0 || maxStackHeight > 0 || maxMemoryBytes > 0;
+}
+
+SearchStats::SearchStats()
+  : configurationsExplored(0),
+    maxStackHeight(0),
+    elapsedMilliseconds(0),
+    peakMemoryBytes(0) {}
+
+std::string SearchStats::toString() const {
+  std::ostringstream out;
+  out << "configurations: " << configurationsExplored
+      << ", max stack height: " << maxStackHeight
+      << ", time: " << elapsedMilliseconds << " ms"
+      << ", memory: " << peakMemoryBytes << " bytes";
+  if (!exceededBudget.empty()) {
+    out << ", exceeded: " << exceededBudget;
+  }
+  return out.str();
+}
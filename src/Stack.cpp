@@ -1,20 +1,20 @@
 
 #include "../include/Stack.h"
 
-Stack::Stack(char initialSymbol) {
+Stack::Stack(Symbol initialSymbol) {
   stackContainer.push_back(initialSymbol);
 }
 
-void Stack::push(const std::string& symbols) {
+void Stack::push(const SymbolString& symbols) {
   // Push symbols onto the stack in reverse order
   for (auto it = symbols.rbegin(); it != symbols.rend(); ++it) {
     stackContainer.push_back(*it);
   }
 }
 
-char Stack::pop() {
+Symbol Stack::pop() {
   if (!stackContainer.empty()) {
-    char top = stackContainer.back();
+    Symbol top = stackContainer.back();
     stackContainer.pop_back();
     return top;
   }
@@ -24,7 +24,7 @@ char Stack::pop() {
   }
 }
 
-char Stack::peek() const {
+Symbol Stack::peek() const {
   if (!stackContainer.empty()) {
     return stackContainer.back();
   }
@@ -37,10 +37,26 @@ bool Stack::isEmpty() const {
   return stackContainer.empty();
 }
 
+size_t Stack::size() const {
+  return stackContainer.size();
+}
+
+const std::vector<Symbol>& Stack::getContents() const {
+  return stackContainer;
+}
+
 std::string Stack::display() const {
   std::string stackContents;
   for (auto it = stackContainer.rbegin(); it != stackContainer.rend(); ++it) {
-    stackContents += *it;
+    stackContents += symbolToText(*it);
   }
   return stackContents;
 }
+
+bool Stack::operator<(const Stack& other) const {
+  return stackContainer < other.stackContainer;
+}
+
+bool Stack::operator==(const Stack& other) const {
+  return stackContainer == other.stackContainer;
+}
@@ -0,0 +1,58 @@
+#include "../include/Symbol.h"
+#include <algorithm>
+
+std::string symbolToText(Symbol symbol) {
+  uint32_t value = symbolValue(symbol);
+  if (PDA_SYMBOL_BITS == 8 || (value > ' ' && value < 0x7F)) {
+    return std::string(1, static_cast<char>(value));
+  }
+  return "<" + std::to_string(value) + ">";
+}
+
+std::string symbolsToText(const SymbolString& symbols) {
+  std::string text;
+  appendSymbols(text, symbols);
+  return text;
+}
+
+void appendSymbols(std::string& text, const SymbolString& symbols) {
+#if PDA_SYMBOL_BITS == 8
+  text += symbols;
+#else
+  for (Symbol symbol : symbols) {
+    text += symbolToText(symbol);
+  }
+#endif
+}
+
+SymbolString textToSymbols(const std::string& text) {
+#if PDA_SYMBOL_BITS == 8
+  return text;
+#else
+  SymbolString symbols;
+  symbols.reserve(text.size());
+  for (char byte : text) {
+    symbols += static_cast<Symbol>(static_cast<unsigned char>(byte));
+  }
+  return symbols;
+#endif
+}
+
+// A '<' that does not open a <digits> group is the symbol '<' itself
+bool parseSymbol(const char* text, size_t length, size_t& position, Symbol& symbol) {
+  if (text[position] == '<') {
+    size_t end = position + 1;
+    uint64_t value = 0;
+    while (end < length && text[end] >= '0' && text[end] <= '9') {
+      value = std::min<uint64_t>(value * 10 + static_cast<uint64_t>(text[end] - '0'), uint64_t(1) << 32);
+      end++;
+    }
+    if (end > position + 1 && end < length && text[end] == '>') {
+      position = end + 1;
+      symbol = static_cast<Symbol>(value);
+      return value > 0 && value <= MAX_SYMBOL_VALUE;
+    }
+  }
+  symbol = static_cast<Symbol>(static_cast<unsigned char>(text[position++]));
+  return true;
+}
@@ -1,10 +1,10 @@
 #include "../include/Transition.h"
 
 Transition::Transition(const State& currentState,
-                       char inputSymbol,
-                       char stackSymbol,
+                       Symbol inputSymbol,
+                       Symbol stackSymbol,
                        const State& nextState,
-                       const std::string& symbolsToPush)
+                       const SymbolString& symbolsToPush)
   : currentState(currentState),
     inputSymbol(inputSymbol),
     stackSymbol(stackSymbol),
@@ -16,11 +16,11 @@ State Transition::getCurrentState() const {
   return currentState;
 }
 
-char Transition::getInputSymbol() const {
+Symbol Transition::getInputSymbol() const {
   return inputSymbol;
 }
 
-char Transition::getStackSymbol() const {
+Symbol Transition::getStackSymbol() const {
   return stackSymbol;
 }
 
@@ -28,7 +28,7 @@ State Transition::getNextState() const {
   return nextState;
 }
 
-std::string Transition::getSymbolsToPush() const {
+SymbolString Transition::getSymbolsToPush() const {
   return symbolsToPush;
 }
 
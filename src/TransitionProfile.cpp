@@ -0,0 +1,140 @@
+#include "../include/TransitionProfile.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+
+TransitionProfile::TransitionProfile(size_t transitionCount, uint64_t fingerprint)
+  : automatonFingerprint(fingerprint),
+    successCounts(transitionCount, 0),
+    attemptCounts(transitionCount, 0),
+    acceptedInputs(0) {}
+
+void TransitionProfile::record(const std::vector<size_t>& witness) {
+  for (size_t index : witness) {
+    if (index >= successCounts.size()) {
+      successCounts.resize(index + 1, 0);
+    }
+    successCounts[index]++;
+  }
+  acceptedInputs++;
+}
+
+const std::vector<size_t>& TransitionProfile::getSuccessCounts() const {
+  return successCounts;
+}
+
+std::vector<size_t>& TransitionProfile::getAttemptCounts() {
+  return attemptCounts;
+}
+
+const std::vector<size_t>& TransitionProfile::getAttemptCounts() const {
+  return attemptCounts;
+}
+
+size_t TransitionProfile::getAcceptedInputs() const {
+  return acceptedInputs;
+}
+
+// File format: a "fingerprint <hex>" line, a "transitions <n>" line, an "inputs <n>" line and one
+// "<index> <successes> <attempts>" line per transition. Lines starting with # are comments.
+bool TransitionProfile::save(const std::string& filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error opening profile file: " << filename << std::endl;
+    return false;
+  }
+  char digits[32];
+  std::snprintf(digits, sizeof(digits), "%016llx", static_cast<unsigned long long>(automatonFingerprint));
+  file << "# PDA transition profile: times each transition lies on an accepting path and times it was tried\n";
+  file << "fingerprint " << digits << "\n";
+  file << "transitions " << successCounts.size() << "\n";
+  file << "inputs " << acceptedInputs << "\n";
+  for (size_t index = 0; index < successCounts.size(); ++index) {
+    file << index << " " << successCounts[index] << " " << attemptCounts[index] << "\n";
+  }
+  file.close();
+  if (!file.good()) {
+    std::cerr << "Error writing profile file: " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TransitionProfile::load(const std::string& filename) {
+  size_t expectedTransitionCount = successCounts.size();
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Error opening profile file: " << filename << std::endl;
+    return false;
+  }
+
+  std::vector<size_t> counts;
+  std::vector<size_t> attempts;
+  size_t inputs = 0;
+  size_t transitionCount = 0;
+  bool hasFingerprint = false;
+  bool hasHeader = false;
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    if (line.empty() || line[0] == '#' || line[0] == '\r') {
+      continue;
+    }
+    std::istringstream ss(line);
+    std::string key;
+    ss >> key;
+    if (key == "fingerprint") {
+      std::string value;
+      ss >> value;
+      if (value.empty() || value.find_first_not_of("0123456789abcdef") != std::string::npos) {
+        std::cerr << "Error: Invalid fingerprint in line " << lineNumber << " of profile file: " << filename << std::endl;
+        return false;
+      }
+      if (std::strtoull(value.c_str(), nullptr, 16) != automatonFingerprint) {
+        std::cerr << "Error: The profile was recorded for another automaton." << std::endl;
+        return false;
+      }
+      hasFingerprint = true;
+      continue;
+    }
+    if (key == "transitions") {
+      ss >> transitionCount;
+      if (transitionCount != expectedTransitionCount) {
+        std::cerr << "Error: The profile describes " << transitionCount << " transitions but the automaton has "
+                  << expectedTransitionCount << "." << std::endl;
+        return false;
+      }
+      counts.assign(transitionCount, 0);
+      attempts.assign(transitionCount, 0);
+      hasHeader = true;
+      continue;
+    }
+    if (key == "inputs") {
+      ss >> inputs;
+      continue;
+    }
+    size_t index = 0;
+    size_t count = 0;
+    size_t attempted = 0;
+    std::istringstream entry(line);
+    if (!hasHeader || !(entry >> index >> count >> attempted) || index >= counts.size()) {
+      std::cerr << "Error: Invalid profile entry in line " << lineNumber << ": '" << line << "'" << std::endl;
+      return false;
+    }
+    counts[index] = count;
+    attempts[index] = attempted;
+  }
+  if (!hasHeader || !hasFingerprint) {
+    std::cerr << "Error: Missing '" << (hasHeader ? "fingerprint" : "transitions") << "' line in profile file: "
+              << filename << std::endl;
+    return false;
+  }
+
+  successCounts = counts;
+  attemptCounts = attempts;
+  acceptedInputs = inputs;
+  return true;
+}
@@ -0,0 +1,287 @@
+#include "../include/ViabilityAutomaton.h"
+#include <unordered_set>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+const size_t ViabilityAutomaton::UNREACHABLE = static_cast<size_t>(-1);
+
+typedef std::array<size_t, 4> Edge;  // (state, stack symbol, target, weight)
+typedef std::array<size_t, 3> Single; // (p, X, weight) of a rule (p, X) -> (q, Y)
+typedef std::array<size_t, 4> Double; // (p, X, Z, weight) of a rule (p, X) -> (q, Y Z)
+
+// Working state of the saturation. Normalized rules push one or two symbols and are indexed by
+// the (state, top) they leave behind; a rule that pops is an edge straight away. Edges only
+// ever lead to control states, acceptAny or end, never to the fresh states of split rules.
+// A rule weighs 1 if its transition reads an input symbol and 0 otherwise.
+struct Saturation {
+  size_t symbolCount;
+  size_t targetCount;
+  size_t stateCount; // Grows with the fresh states
+  size_t maxWeight;
+  std::unordered_map<size_t, std::vector<Single> > singles; // (q, Y) -> rules (p, X) -> (q, Y)
+  std::unordered_map<size_t, std::vector<Double> > doubles; // (q, Y) -> rules (p, X) -> (q, Y Z)
+  std::unordered_map<size_t, std::vector<size_t> > processed; // (p, X) -> targets
+  std::unordered_map<uint64_t, size_t> weights; // Best weight of each edge
+  std::unordered_set<uint64_t> listed;           // Edges already in processed
+  std::vector<Edge> worklist;
+};
+
+static uint64_t edgeCode(const Saturation& saturation, size_t state, size_t symbol, size_t target) {
+  return (static_cast<uint64_t>(state) * saturation.symbolCount + symbol) * saturation.targetCount + target;
+}
+
+// Adds the edge or lowers its weight; either way it goes (back) on the worklist
+static void addEdge(Saturation& saturation, size_t state, size_t symbol, size_t target, size_t weight) {
+  weight = std::min(weight, saturation.maxWeight);
+  auto inserted = saturation.weights.insert(std::make_pair(edgeCode(saturation, state, symbol, target), weight));
+  if (inserted.second || weight < inserted.first->second) {
+    inserted.first->second = weight;
+    saturation.worklist.push_back(Edge{{state, symbol, target, weight}});
+  }
+}
+
+static void addDouble(Saturation& saturation, size_t state, size_t symbol, size_t next, size_t top, size_t below,
+                      size_t weight) {
+  saturation.doubles[next * saturation.symbolCount + top].push_back(Double{{state, symbol, below, weight}});
+}
+
+// Rule (state, symbol) -> (next, word), word[0] on top. Longer words are pushed one symbol at a
+// time, bottom first: (p, X) -> (r1, w[k-2] w[k-1]), (r1, w[k-2]) -> (r2, w[k-3] w[k-2]), ...
+// The first of them carries the weight.
+static void addRule(Saturation& saturation, size_t state, size_t symbol, size_t next, const std::vector<size_t>& word,
+                    size_t weight) {
+  size_t length = word.size();
+  if (length == 0) {
+    addEdge(saturation, state, symbol, next, weight);
+  }
+  else if (length == 1) {
+    saturation.singles[next * saturation.symbolCount + word[0]].push_back(Single{{state, symbol, weight}});
+  }
+  else {
+    for (size_t i = length - 1; i >= 1; --i) {
+      size_t target = i == 1 ? next : saturation.stateCount++;
+      addDouble(saturation, state, symbol, target, word[i - 1], word[i], weight);
+      state = target;
+      symbol = word[i - 1];
+      weight = 0;
+    }
+  }
+}
+
+ViabilityAutomaton::ViabilityAutomaton(const PDA& pda, size_t maxDistance)
+  : maxWeight(maxDistance + 1),
+    edgeCount(0) {
+  for (const auto& state : pda.getStates()) {
+    size_t index = stateIndex.size();
+    stateIndex[state] = index;
+  }
+  for (Symbol symbol : pda.getStackAlphabet()) {
+    size_t index = symbolIndex.size();
+    symbolIndex[symbol] = index;
+  }
+  symbolCount = symbolIndex.size() + 1;
+  size_t bottom = symbolCount - 1;
+  acceptAny = stateIndex.size();
+  end = acceptAny + 1;
+
+  Saturation saturation;
+  saturation.symbolCount = symbolCount;
+  saturation.targetCount = end + 1;
+  saturation.stateCount = end + 1;
+  saturation.maxWeight = maxWeight;
+
+  // Accepting configurations: a final state over any stack (APf) or any state over the empty stack (APv)
+  if (pda.getUseFinalStateAcceptance()) {
+    for (const auto& state : pda.getFinalStates()) {
+      for (size_t symbol = 0; symbol < bottom; ++symbol) {
+        addEdge(saturation, stateIndex[state], symbol, acceptAny, 0);
+      }
+      addEdge(saturation, stateIndex[state], bottom, end, 0);
+    }
+    for (size_t symbol = 0; symbol < bottom; ++symbol) {
+      addEdge(saturation, acceptAny, symbol, acceptAny, 0);
+    }
+    addEdge(saturation, acceptAny, bottom, end, 0);
+  }
+  else {
+    for (size_t state = 0; state < acceptAny; ++state) {
+      addEdge(saturation, state, bottom, end, 0);
+    }
+  }
+
+  for (const auto& transition : pda.getTransitions()) {
+    size_t state = stateIndex[transition.getCurrentState()];
+    size_t next = stateIndex[transition.getNextState()];
+    size_t weight = transition.getInputSymbol() != '\0' ? 1 : 0;
+    std::vector<size_t> word;
+    for (Symbol symbol : transition.getSymbolsToPush()) {
+      word.push_back(symbolIndex[symbol]);
+    }
+    if (transition.getStackSymbol() != '\0') {
+      addRule(saturation, state, symbolIndex[transition.getStackSymbol()], next, word, weight);
+      continue;
+    }
+    // (p, Y) -> (q, w Y) for every Y: the first push goes through a state shared by all of them
+    if (word.empty()) {
+      for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+        saturation.singles[key(next, symbol)].push_back(Single{{state, symbol, weight}});
+      }
+      continue;
+    }
+    size_t last = word.back();
+    size_t pushed = word.size() == 1 ? next : saturation.stateCount++;
+    for (size_t symbol = 0; symbol < symbolCount; ++symbol) {
+      addDouble(saturation, state, symbol, pushed, last, symbol, weight);
+    }
+    if (word.size() > 1) {
+      addRule(saturation, pushed, last, next, word, 0);
+    }
+  }
+
+  // An edge q -Y-> s of weight w makes every rule (p, X) -> (q, Y) of weight c an edge p -X-> s
+  // of weight c + w, and turns every rule (p, X) -> (q, Y Z) into the one-symbol rule
+  // (p, X) -> (s, Z) of weight c + w. An edge whose weight was lowered after it was queued is
+  // handled once, at its best weight.
+  while (!saturation.worklist.empty()) {
+    Edge edge = saturation.worklist.back();
+    saturation.worklist.pop_back();
+    size_t source = key(edge[0], edge[1]);
+    size_t target = edge[2];
+    size_t weight = edge[3];
+    if (saturation.weights[edgeCode(saturation, edge[0], edge[1], target)] < weight) {
+      continue;
+    }
+    if (saturation.listed.insert(edgeCode(saturation, edge[0], edge[1], target)).second) {
+      saturation.processed[source].push_back(target);
+    }
+
+    auto single = saturation.singles.find(source);
+    if (single != saturation.singles.end()) {
+      for (const auto& rule : single->second) {
+        addEdge(saturation, rule[0], rule[1], target, rule[2] + weight);
+      }
+    }
+    auto pair = saturation.doubles.find(source);
+    if (pair != saturation.doubles.end()) {
+      for (const auto& rule : pair->second) {
+        size_t rest = key(target, rule[2]);
+        size_t ruleWeight = std::min(rule[3] + weight, maxWeight);
+        saturation.singles[rest].push_back(Single{{rule[0], rule[1], ruleWeight}});
+        auto done = saturation.processed.find(rest);
+        if (done != saturation.processed.end()) {
+          for (size_t i = 0; i < done->second.size(); ++i) {
+            size_t next = done->second[i];
+            addEdge(saturation, rule[0], rule[1], next,
+                    ruleWeight + saturation.weights[edgeCode(saturation, target, rule[2], next)]);
+          }
+        }
+      }
+    }
+  }
+
+  // Queries start at a control state, so the fresh states are no longer needed
+  successors.assign((end + 1) * symbolCount, std::vector<WeightedTarget>());
+  for (const auto& entry : saturation.processed) {
+    if (entry.first < successors.size()) {
+      size_t state = entry.first / symbolCount;
+      size_t symbol = entry.first % symbolCount;
+      for (size_t target : entry.second) {
+        size_t weight = saturation.weights[edgeCode(saturation, state, symbol, target)];
+        successors[entry.first].push_back(WeightedTarget(target, weight));
+      }
+    }
+  }
+  edgeCount = saturation.weights.size();
+}
+
+size_t ViabilityAutomaton::key(size_t state, size_t symbol) const {
+  return state * symbolCount + symbol;
+}
+
+bool ViabilityAutomaton::isViable(const Configuration& configuration) const {
+  return distance(configuration) != UNREACHABLE;
+}
+
+// Runs the automaton over the stack from the top, then over the bottom marker, keeping the
+// lightest way to reach each state
+size_t ViabilityAutomaton::distance(const Configuration& configuration) const {
+  auto state = stateIndex.find(configuration.getState());
+  if (state == stateIndex.end()) {
+    return UNREACHABLE;
+  }
+  size_t best = UNREACHABLE;
+  std::vector<size_t> current(end + 1, UNREACHABLE);
+  std::vector<size_t> next(end + 1, UNREACHABLE);
+  std::vector<size_t> active(1, state->second);
+  std::vector<size_t> reached;
+  current[state->second] = 0;
+  const std::vector<Symbol>& contents = configuration.getStack().getContents();
+  for (auto it = contents.rbegin(); it != contents.rend() && !active.empty(); ++it) {
+    auto symbol = symbolIndex.find(*it);
+    if (symbol == symbolIndex.end()) {
+      return best;
+    }
+    reached.clear();
+    for (size_t from : active) {
+      for (const auto& edge : successors[key(from, symbol->second)]) {
+        size_t weight = std::min(current[from] + edge.second, maxWeight);
+        if (edge.first == acceptAny) {
+          best = std::min(best, weight); // Reads whatever is left
+        }
+        else if (edge.first < acceptAny && weight < next[edge.first]) {
+          if (next[edge.first] == UNREACHABLE) {
+            reached.push_back(edge.first);
+          }
+          next[edge.first] = weight;
+        }
+      }
+      current[from] = UNREACHABLE;
+    }
+    active.swap(reached);
+    current.swap(next);
+  }
+  for (size_t from : active) {
+    for (const auto& edge : successors[key(from, symbolCount - 1)]) {
+      if (edge.first == end || edge.first == acceptAny) {
+        best = std::min(best, std::min(current[from] + edge.second, maxWeight));
+      }
+    }
+  }
+  return best;
+}
+
+std::vector<bool> ViabilityAutomaton::viableOnEmptyStack() const {
+  std::vector<bool> viable(acceptAny, false);
+  for (size_t state = 0; state < acceptAny; ++state) {
+    for (const auto& edge : successors[key(state, symbolCount - 1)]) {
+      viable[state] = viable[state] || edge.first == end;
+    }
+  }
+  return viable;
+}
+
+std::vector<bool> ViabilityAutomaton::viableOnPush(Symbol top, const std::vector<bool>& below) const {
+  std::vector<bool> viable(acceptAny, false);
+  auto symbol = symbolIndex.find(top);
+  if (symbol == symbolIndex.end()) {
+    return viable;
+  }
+  for (size_t state = 0; state < acceptAny; ++state) {
+    for (const auto& edge : successors[key(state, symbol->second)]) {
+      if (edge.first == acceptAny || (edge.first < acceptAny && below[edge.first])) {
+        viable[state] = true;
+        break;
+      }
+    }
+  }
+  return viable;
+}
+
+size_t ViabilityAutomaton::getStateIndex(const State& state) const {
+  return stateIndex.find(state)->second;
+}
+
+size_t ViabilityAutomaton::getEdgeCount() const {
+  return edgeCount;
+}
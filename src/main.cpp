@@ -9,19 +9,54 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
 #include "../include/PDA.h"
 #include "../include/InputHandler.h"
+#include "../include/BatchProcessor.h"
+#include "../include/TransitionProfile.h"
+#include "../include/InputEncoder.h"
+#include "../include/CounterPDA.h"
+#include "../include/ResultWriter.h"
+#include "../include/ResultCache.h"
+#include "../include/ComputationCounter.h"
+#include "../include/LanguageGenerator.h"
+#include "../include/AutomatonAnalyzer.h"
+#include "../include/PDASession.h"
 #include "../include/Utility.h"
 
-
+// Parses a non-negative integer command-line value
+static bool parseSize(const std::string& text, size_t& value) {
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  value = static_cast<size_t>(std::strtoull(text.c_str(), nullptr, 10));
+  return true;
+}
 
 int main(int argc, char* argv[]) {
+  // Results go through ResultWriter's own buffer; C stdio is not used
+  std::ios::sync_with_stdio(false);
+
   // Variables to store command-line arguments
   std::string automatonDefinitionFile;
   std::string inputStringsFile;
   std::string mode = "none"; // Default mode
   std::string outputFile;
   std::string acceptanceType = "apf"; // Default acceptance type
+  SearchBudget budget; // Unlimited by default
+  std::string profileInputFile;
+  std::string profileOutputFile;
+  std::vector<std::string> parikhConstraints;
+  bool useCounterEngine = true;
+  OutputFormat outputFormat = OutputFormat::Text;
+  bool showSummary = false;
+  std::string cacheFile;
+  bool tokenInput = false;
+  size_t generateLength = 10;
+  size_t generateCount = 0; // enumerate: all strings, sample: one string
+  size_t seed = 0;
 
   // Parse command-line arguments
   if (argc < 2) {
@@ -66,6 +101,81 @@ int main(int argc, char* argv[]) {
         return 1;
       }
     }
+    else if (arg == "--profile-in" || arg == "--profile-out") {
+      if (argIndex + 1 < argc) {
+        (arg == "--profile-in" ? profileInputFile : profileOutputFile) = argv[++argIndex];
+      }
+      else {
+        std::cerr << "Error: Missing profile file after " << arg << "\n";
+        return 1;
+      }
+    }
+    else if (arg == "-f" || arg == "--format") {
+      if (argIndex + 1 >= argc || !ResultWriter::parseFormat(argv[argIndex + 1], outputFormat)) {
+        std::cerr << "Error: Missing or invalid format after " << arg << ". Use 'text', 'compact', 'csv' or 'jsonl'.\n";
+        return 1;
+      }
+      argIndex++;
+    }
+    else if (arg == "-q" || arg == "--quiet") {
+      outputFormat = OutputFormat::Compact;
+    }
+    else if (arg == "--cache") {
+      if (argIndex + 1 < argc) {
+        cacheFile = argv[++argIndex];
+      }
+      else {
+        std::cerr << "Error: Missing cache file after " << arg << "\n";
+        return 1;
+      }
+    }
+    else if (arg == "--tokens") {
+      tokenInput = true;
+    }
+    else if (arg == "--summary") {
+      showSummary = true;
+    }
+    else if (arg == "--no-counter") {
+      useCounterEngine = false;
+    }
+    else if (arg == "--parikh") {
+      if (argIndex + 1 < argc) {
+        parikhConstraints.push_back(argv[++argIndex]);
+      }
+      else {
+        std::cerr << "Error: Missing constraint after " << arg << "\n";
+        return 1;
+      }
+    }
+    else if (arg == "--length" || arg == "--count" || arg == "--seed") {
+      size_t value = 0;
+      if (argIndex + 1 >= argc || !parseSize(argv[argIndex + 1], value)) {
+        std::cerr << "Error: Missing or invalid number after " << arg << "\n";
+        return 1;
+      }
+      argIndex++;
+      (arg == "--length" ? generateLength : arg == "--count" ? generateCount : seed) = value;
+    }
+    else if (arg == "--max-steps" || arg == "--max-time" || arg == "--max-stack" || arg == "--max-memory") {
+      size_t limit = 0;
+      if (argIndex + 1 >= argc || !parseSize(argv[argIndex + 1], limit)) {
+        std::cerr << "Error: Missing or invalid limit after " << arg << "\n";
+        return 1;
+      }
+      argIndex++;
+      if (arg == "--max-steps") {
+        budget.setMaxConfigurations(limit);
+      }
+      else if (arg == "--max-time") {
+        budget.setMaxMilliseconds(limit);
+      }
+      else if (arg == "--max-stack") {
+        budget.setMaxStackHeight(limit);
+      }
+      else {
+        budget.setMaxMemoryBytes(limit);
+      }
+    }
     else if (automatonDefinitionFile.empty()) {
       automatonDefinitionFile = arg;
     }
@@ -80,13 +190,46 @@ int main(int argc, char* argv[]) {
     argIndex++;
   }
 
-  // Check if required files are provided
-  if (automatonDefinitionFile.empty() || inputStringsFile.empty()) {
+  // Check if required files are provided (generation and analysis modes take no input strings)
+  bool generationMode = mode == "enumerate" || mode == "sample";
+  if (automatonDefinitionFile.empty() || (inputStringsFile.empty() && !generationMode && mode != "analyze")) {
     std::cerr << "Error: Missing automaton definition file or input strings file.\n";
     displayHelp();
     return 1;
   }
 
+  // Check the execution mode
+  if (mode != "none" && mode != "trace" && mode != "tracefile" && mode != "trie" && mode != "witness" &&
+      mode != "count" && mode != "online" && mode != "analyze" && !generationMode) {
+    std::cerr << "Error: Invalid mode '" << mode << "'. Use 'none', 'trace', 'tracefile', 'trie', 'witness', 'count', "
+              << "'online', 'analyze', 'enumerate' or 'sample'.\n";
+    return 1;
+  }
+  if (!profileOutputFile.empty() && mode != "none" && mode != "witness") {
+    std::cerr << "Error: --profile-out is only supported in modes 'none' and 'witness'.\n";
+    return 1;
+  }
+  if (!cacheFile.empty() && !((mode == "none" && profileOutputFile.empty()) || mode == "trie")) {
+    std::cerr << "Error: --cache is only supported in modes 'none' (without --profile-out) and 'trie'.\n";
+    return 1;
+  }
+  if (mode == "tracefile" && outputFile.empty()) {
+    std::cerr << "Error: Output file not specified for tracefile mode.\n";
+    return 1;
+  }
+
+  // The depth-first search modes honour every limit; the modes that simulate sets of
+  // configurations only bound the stack, and the trace, counting and analysis modes none
+  bool searchLimited = budget.getMaxConfigurations() > 0 || budget.getMaxMilliseconds() > 0 ||
+                       budget.getMaxMemoryBytes() > 0;
+  bool stackLimitOnly = mode == "trie" || mode == "online" || generationMode;
+  if (mode != "none" && mode != "witness" && (searchLimited || (!stackLimitOnly && budget.isLimited()))) {
+    std::cerr << "Error: Mode '" << mode << "' does not support "
+              << (stackLimitOnly ? "--max-steps, --max-time or --max-memory (only --max-stack).\n"
+                                 : "search limits (--max-steps, --max-time, --max-stack, --max-memory).\n");
+    return 1;
+  }
+
   // Determine acceptance criteria
   bool useFinalStateAcceptance = true;
   if (acceptanceType == "apf") {
@@ -109,43 +252,271 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
-  // Load input strings
-  std::vector<std::string> inputStrings = InputHandler::loadInputStrings(inputStringsFile);
+  // Analysis mode: report on the sources of search blowup in the definition
+  if (mode == "analyze") {
+    AutomatonAnalyzer analyzer(pda);
+    analyzer.writeReport(std::cout);
+    return 0;
+  }
+
+  // Modes that close sets of configurations under epsilon transitions need a stack bound when an
+  // epsilon cycle can grow the stack. A closure can hold every stack up to the bound, so no default
+  // is small enough to be safe for every stack alphabet: the user has to give --max-stack.
+  bool closesConfigurationSets = mode == "trie" || mode == "online" || generationMode;
+  if (closesConfigurationSets && budget.getMaxStackHeight() == 0 && AutomatonAnalyzer(pda).hasGrowingEpsilonCycle()) {
+    std::cerr << "Error: An epsilon cycle can grow the stack, so the epsilon closures of mode '" << mode
+              << "' can be unbounded. Give a stack limit with --max-stack.\n";
+    return 1;
+  }
+
+  // Generation modes: accepted strings of length up to --length, exhaustively or sampled uniformly
+  if (generationMode) {
+    auto start = std::chrono::steady_clock::now();
+    LanguageGenerator generator(pda, generateLength, budget.getMaxStackHeight());
+    if (generator.isTruncated()) {
+      std::cerr << "Warning: The stack limit discarded configurations; some strings may be missing.\n";
+    }
+    size_t written = 0;
+    if (mode == "enumerate") {
+      written = generator.enumerate(std::cout, generateCount);
+    }
+    else {
+      written = generateCount == 0 ? 1 : generateCount;
+      if (!generator.sample(std::cout, written, seed)) {
+        std::cerr << "Error: Too many accepted strings to sample uniformly; use a smaller --length.\n";
+        return 1;
+      }
+      if (generator.countStrings() == 0) {
+        written = 0;
+      }
+    }
+    if (showSummary) {
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cerr << "Accepted strings of length <= " << generateLength << ": " << generator.countStrings()
+                << " (" << generator.getNodeCount() << " configuration sets)\n"
+                << "Generated: " << written << " in " << seconds << " s\n";
+    }
+    return 0;
+  }
+
+  // Reorder the dispatch buckets with a previously recorded profile
+  uint64_t fingerprint = ResultCache::fingerprint(pda);
+  if (!profileInputFile.empty()) {
+    TransitionProfile savedProfile(pda.getTransitionCount(), fingerprint);
+    if (!savedProfile.load(profileInputFile)) {
+      std::cerr << "Failed to load transition profile.\n";
+      return 1;
+    }
+    pda.reorderTransitions(savedProfile.getSuccessCounts(), savedProfile.getAttemptCounts());
+  }
+  TransitionProfile profile(pda.getTransitionCount(), fingerprint);
+  bool recordProfile = !profileOutputFile.empty();
+  if (recordProfile) {
+    pda.setAttemptCounts(&profile.getAttemptCounts());
+  }
+
+  // Automata that only stack blocks of a few symbols above the bottom marker run on integer
+  // counters. Compiled after the profile so the buckets keep its order.
+  CounterPDA counterPDA;
+  if (useCounterEngine && mode == "none") {
+    counterPDA.compile(pda);
+  }
+
+  // Load input strings. A token stream is validated as a whole, so a bad token stops the run
+  // before any result is written.
+  std::vector<SymbolString> inputStrings;
+  if (tokenInput) {
+    if (!InputHandler::loadTokenStrings(inputStringsFile, inputStrings)) {
+      std::cerr << "Failed to load input strings.\n";
+      return 1;
+    }
+  }
+  else {
+    inputStrings = InputHandler::loadInputStrings(inputStringsFile);
+  }
   if (inputStrings.empty()) {
     std::cerr << "No input strings to process.\n";
     return 1;
   }
 
+  // Pre-pass: inputs with invalid symbols or violating a Parikh constraint are rejected without
+  // searching. Trace modes always run the full search, and the online mode reports where the
+  // prefix dies.
+  std::vector<bool> mayAccept(inputStrings.size(), true);
+  if (mode != "trace" && mode != "tracefile" && mode != "online") {
+    InputEncoder encoder(pda);
+    for (const auto& constraint : parikhConstraints) {
+      if (!encoder.addConstraint(constraint)) {
+        return 1;
+      }
+    }
+    for (size_t i = 0; i < inputStrings.size(); ++i) {
+      mayAccept[i] = encoder.mayAccept(inputStrings[i]);
+    }
+  }
+
+  // Verdicts of repeated inputs are reused within the run and, with --cache, across runs
+  bool useCache = (mode == "none" && !recordProfile) || mode == "trie";
+  ResultCache cache(fingerprint);
+  if (useCache && !cacheFile.empty()) {
+    cache.load(cacheFile);
+  }
+
+  // Batch mode: all inputs are simulated together over a trie of shared prefixes
+  std::vector<Verdict> batchResults(inputStrings.size(), Verdict::Rejected);
+  if (mode == "trie") {
+    std::vector<SymbolString> batchInputs;
+    std::vector<size_t> batchIndices;
+    for (size_t i = 0; i < inputStrings.size(); ++i) {
+      if (mayAccept[i] && !cache.lookup(inputStrings[i], batchResults[i])) {
+        batchInputs.push_back(inputStrings[i]);
+        batchIndices.push_back(i);
+      }
+    }
+    BatchProcessor batchProcessor(pda);
+    batchProcessor.setMaxStackHeight(budget.getMaxStackHeight());
+    std::vector<Verdict> verdicts = batchProcessor.processBatch(batchInputs);
+    for (size_t i = 0; i < verdicts.size(); ++i) {
+      batchResults[batchIndices[i]] = verdicts[i];
+      cache.store(batchInputs[i], verdicts[i]);
+    }
+  }
+
+  // Counting mode: number of accepting computations of each input, compiled on the first one
+  std::unique_ptr<ComputationCounter> computationCounter;
+
+  // Online mode: each input is fed symbol by symbol to a fork of one session
+  std::unique_ptr<PDASession> onlineSession;
+  if (mode == "online") {
+    onlineSession.reset(new PDASession(pda, budget.getMaxStackHeight()));
+  }
+
   // Process each input string
-  for (const auto& input : inputStrings) {
-    std::cout << "Processing input: " << input << "\n";
+  ResultWriter writer(std::cout, outputFormat);
+  bool invalidWitness = false;
+  for (size_t i = 0; i < inputStrings.size(); ++i) {
+    const SymbolString& input = inputStrings[i];
+    writer.beginInput(input);
     bool accepted = false;
+    Verdict verdict = Verdict::Rejected;
+    SearchStats stats;
+    std::vector<size_t> witness;
+    uint64_t computations = 0;
+    size_t deadAfter = 0;
+    PDASession::Status status = PDASession::DEAD;
 
-    if (mode == "none") {
+    if (!mayAccept[i]) {
+      accepted = false;
+    }
+    else if (mode == "trie") {
+      verdict = batchResults[i];
+      accepted = verdict == Verdict::Accepted;
+    }
+    else if (useCache && cache.lookup(input, verdict)) {
+      accepted = verdict == Verdict::Accepted;
+    }
+    else if (mode == "witness" || recordProfile) {
+      if (budget.isLimited()) {
+        verdict = pda.processInputWitness(input, budget, stats, witness);
+        accepted = verdict == Verdict::Accepted;
+      }
+      else {
+        accepted = pda.processInputWitness(input, witness);
+      }
+      if (accepted && recordProfile) {
+        profile.record(witness);
+      }
+    }
+    else if (mode == "none" && budget.isLimited()) {
+      verdict = pda.processInput(input, budget, stats);
+      accepted = verdict == Verdict::Accepted;
+    }
+    else if (mode == "none" && counterPDA.isCompiled()) {
+      accepted = counterPDA.processInput(input);
+    }
+    else if (mode == "none") {
       accepted = pda.processInput(input);
     }
+    else if (mode == "count") {
+      if (!computationCounter) {
+        computationCounter.reset(new ComputationCounter(pda));
+      }
+      computations = computationCounter->count(input);
+      accepted = computations > 0;
+    }
+    else if (mode == "online") {
+      // A dead prefix ends the input unless the stack limit makes it uncertain; a later symbol
+      // that no transition reads can still settle it
+      PDASession session = onlineSession->fork();
+      status = session.status();
+      for (size_t j = 0; j < input.size() && (status != PDASession::DEAD || session.isTruncated()); ++j) {
+        PDASession::Status previous = status;
+        status = session.feed(input[j]);
+        if (status == PDASession::DEAD && previous != PDASession::DEAD) {
+          deadAfter = j + 1;
+        }
+      }
+      accepted = status == PDASession::ACCEPT;
+      if (!accepted && session.isTruncated()) {
+        verdict = Verdict::Unknown; // The stack limit discarded configurations, as in the trie mode
+      }
+    }
     else if (mode == "trace") {
+      writer.flush(); // The trace is written straight to the console
       accepted = pda.processInputTrace(input, "console");
     }
     else if (mode == "tracefile") {
-      if (outputFile.empty()) {
-        std::cerr << "Error: Output file not specified for tracefile mode.\n";
-        return 1;
-      }
       accepted = pda.processInputTrace(input, outputFile);
     }
-    else {
-      std::cerr << "Error: Invalid mode '" << mode << "'. Use 'none', 'trace', or 'tracefile'.\n";
-      return 1;
+    if (accepted) {
+      verdict = Verdict::Accepted;
+    }
+    if (useCache && mayAccept[i] && mode == "none") {
+      cache.store(input, verdict);
     }
 
-    if (accepted) {
-      std::cout << "Result: Accepted\n\n";
+    std::string details;
+    if (accepted && mode == "witness") {
+      // Every witness is replayed before it is printed
+      if (!pda.checkWitness(input, witness)) {
+        std::cerr << "Error: The witness of input " << i << " is not an accepting computation.\n";
+        invalidWitness = true;
+      }
+      details = "Witness:";
+      for (size_t index : witness) {
+        details += ' ' + std::to_string(index);
+      }
+      details += '\n';
     }
-    else {
-      std::cout << "Result: Rejected\n\n";
+    else if (mode == "count") {
+      details = "Accepting computations: " + ComputationCounter::toString(computations);
+      details += computations > 1 ? " (ambiguous)\n" : "\n";
+    }
+    else if (mode == "online" && status == PDASession::DEAD) {
+      details = "Prefix: dead after " + std::to_string(deadAfter) + " of " + std::to_string(input.size()) + " symbols";
+      details += verdict == Verdict::Unknown ? " (within the stack limit)\n" : "\n";
+    }
+    else if (mode == "online" && status == PDASession::VIABLE_PREFIX) {
+      details = "Prefix: viable (some continuation is accepted)\n";
     }
+    else if (verdict == Verdict::Unknown && mode != "trie") {
+      details = "Stats: " + stats.toString() + "\n";
+    }
+    writer.writeResult(i, verdict, details);
+  }
+  writer.flush();
+  if (showSummary) {
+    writer.writeSummary(std::cerr);
+  }
+
+  if (useCache && !cacheFile.empty() && !cache.save(cacheFile)) {
+    return 1;
+  }
+
+  // Save the profile recorded over this corpus
+  if (recordProfile && !profile.save(profileOutputFile)) {
+    return 1;
   }
 
-  return 0;
+  return invalidWitness ? 1 : 0;
 }